@@ -0,0 +1,181 @@
+#include "../kernel/config.h"
+
+#if ATMOS_SUPPORT_ADC
+
+#include "adc.h"
+
+#include <avr/io.h>
+
+#include "../kernel/interrupt.h"
+#include "../kernel/kernel_lock.h"
+#include "../kernel/wait_list.h"
+
+static_assert(ATMOS_ADC_BLOCK_SIZE > 0 && ATMOS_ADC_BLOCK_SIZE <= 256, "ATMOS_ADC_BLOCK_SIZE must be 1 to 256");
+static_assert(ATMOS_ADC_TRIGGER_SOURCE > 0 && ATMOS_ADC_TRIGGER_SOURCE <= 7,
+	"ATMOS_ADC_TRIGGER_SOURCE has unsupported value. Supported values are 1 to 7.");
+
+#if defined(ADCSRB) && defined(ADTS0)
+#	define ATMOS_ADC_TRIGGER_CONTROL ADCSRB
+#elif defined(SFIOR) && defined(ADTS0)
+#	define ATMOS_ADC_TRIGGER_CONTROL SFIOR
+#else //ADC trigger control register
+static_assert(false, "ADC auto trigger source selection is not defined for selected device");
+#endif //ADC trigger control register
+
+namespace
+{
+
+///State of the block, which is not being filled by ADC interrupt handler.
+enum class block_state : uint8_t
+{
+	///Block can be filled next.
+	free,
+	///Block is filled and waits for consumer.
+	ready,
+	///Block is owned by consumer.
+	consumed
+};
+
+atmos::adc::sample_type blocks[2][ATMOS_ADC_BLOCK_SIZE];
+
+///Index of block, which is being filled by ADC interrupt handler.
+uint8_t filling_block;
+
+///Number of samples in block being filled.
+uint16_t sample_count;
+
+///State of another block.
+block_state other_block_state;
+
+///Channels to sample.
+atmos::span<const uint8_t> channels;
+
+///Index of channel, which is selected for the next conversion.
+uint8_t next_channel;
+
+///ADMUX reference selection bits.
+uint8_t reference_bits;
+
+uint16_t overruns;
+
+atmos::wait_list consumer;
+
+///<summary>Returns ADC clock prescaler bits value, so that ADC clock does not exceed 200 kHz.</summary>
+constexpr uint8_t get_prescaler(uint8_t divider_log2 = 1)
+{
+	return divider_log2 == 7 || (static_cast<uint32_t>(F_CPU) >> divider_log2) <= 200000ul
+		? divider_log2 : get_prescaler(divider_log2 + 1);
+}
+
+///<summary>Selects next channel in sequence.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+void select_next_channel()
+{
+	ADMUX = reference_bits | channels[next_channel];
+	if(++next_channel == channels.size())
+		next_channel = 0;
+}
+
+///<summary>Releases block, which was received by consumer.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+void release_consumed_block()
+{
+	if(other_block_state == block_state::consumed)
+		other_block_state = block_state::free;
+}
+
+///<summary>Returns true if block is filled and waits for consumer.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+bool is_block_ready()
+{
+	return other_block_state == block_state::ready;
+}
+
+///<summary>Passes ready block to consumer.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+///<returns>Ready block.</returns>
+atmos::span<const atmos::adc::sample_type> consume_ready_block()
+{
+	other_block_state = block_state::consumed;
+	return atmos::span<const atmos::adc::sample_type>(blocks[filling_block ^ 1]);
+}
+
+} //namespace
+
+namespace atmos
+{
+
+void adc::start(span<const uint8_t> sampled_channels, uint8_t reference)
+{
+	atmos::kernel_lock lock;
+	channels = sampled_channels;
+	reference_bits = reference;
+	next_channel = 0;
+	filling_block = 0;
+	sample_count = 0;
+	other_block_state = block_state::free;
+	select_next_channel();
+
+	ATMOS_ADC_TRIGGER_CONTROL = static_cast<uint8_t>((ATMOS_ADC_TRIGGER_CONTROL & ~(7 << ADTS0))
+		| (ATMOS_ADC_TRIGGER_SOURCE << ADTS0));
+	ATMOS_ADC_TRIGGER_FLAG_REGISTER = _BV(ATMOS_ADC_TRIGGER_FLAG_BIT);
+	ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIF) | _BV(ADIE) | (get_prescaler() << ADPS0);
+}
+
+void adc::stop()
+{
+	atmos::kernel_lock lock;
+	ADCSRA = _BV(ADIF);
+}
+
+span<const adc::sample_type> adc::receive()
+{
+	atmos::kernel_lock lock;
+	release_consumed_block();
+	consumer.wait(is_block_ready);
+	return consume_ready_block();
+}
+
+span<const adc::sample_type> adc::receive_for(process::tick_t ticks)
+{
+	atmos::kernel_lock lock;
+	release_consumed_block();
+	if(!consumer.wait_for(ticks, is_block_ready))
+		return span<const sample_type>();
+
+	return consume_ready_block();
+}
+
+uint16_t adc::overrun_count()
+{
+	atmos::kernel_lock lock;
+	return overruns;
+}
+
+} //namespace atmos
+
+ATMOS_ISR(ADC_vect)
+{
+	//Trigger event flag is not cleared automatically, if trigger timer interrupt is disabled.
+	ATMOS_ADC_TRIGGER_FLAG_REGISTER = _BV(ATMOS_ADC_TRIGGER_FLAG_BIT);
+
+	//Conversion for the current channel is completed, and the next one is not started yet.
+	blocks[filling_block][sample_count] = ADCW;
+	select_next_channel();
+	if(++sample_count != ATMOS_ADC_BLOCK_SIZE)
+		return;
+
+	sample_count = 0;
+	if(other_block_state != block_state::free)
+	{
+		//Consumer still owns another block, drop this one.
+		++overruns;
+		return;
+	}
+
+	filling_block ^= 1;
+	other_block_state = block_state::ready;
+	consumer.notify_one();
+}
+
+#endif //ATMOS_SUPPORT_ADC
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <avr/io.h>
+#include <stdint.h>
+
+#include "../kernel/config.h"
+
+#if ATMOS_SUPPORT_ADC
+
+#include "../kernel/process.h"
+#include "../kernel/span.h"
+#include "../kernel/static_class.h"
+
+#if !ATMOS_SUPPORT_SLEEP
+static_assert(false, "ATMOS_SUPPORT_ADC requires ATMOS_SUPPORT_SLEEP");
+#endif //!ATMOS_SUPPORT_SLEEP
+
+#if ATMOS_SINGLE_STACK_MODE
+static_assert(false, "ATMOS_SUPPORT_ADC can not be used in single-stack mode");
+#endif //ATMOS_SINGLE_STACK_MODE
+
+#ifndef ADATE
+static_assert(false, "Selected device does not support ADC auto triggering");
+#endif //ADATE
+
+namespace atmos
+{
+
+///ADC sampling driver. ADC conversions are started by auto trigger source (see ATMOS_ADC_TRIGGER_SOURCE),
+///and channels are switched by ADC interrupt handler in sequence. Samples are stored to one of two blocks,
+///while another block is processed by consumer process, which is woken up once per ATMOS_ADC_BLOCK_SIZE samples.
+///If consumer does not release previous block in time, the block being filled is dropped and overrun is counted.
+class adc final : public static_class
+{
+public:
+	///Sample type (right-adjusted ADC conversion result).
+	using sample_type = uint16_t;
+
+public:
+	///<summary>Enables ADC and starts sampling.</summary>
+	///<remarks>ADC clock prescaler is chosen so that ADC clock does not exceed 200 kHz.</remarks>
+	///<param name="channels">ADC channels (ADMUX multiplexer values) to sample in sequence. Can not be empty,
+	///                       and must be valid until sampling is stopped. Samples in block are interleaved
+	///                       in channel order. If block size is a multiple of channel count, each block starts
+	///                       with the first channel sample.</param>
+	///<param name="reference">ADMUX reference selection bits, for example, _BV(REFS0).</param>
+	static void start(span<const uint8_t> channels, uint8_t reference);
+
+	///<summary>Stops sampling and disables ADC. Partially filled block is dropped.</summary>
+	static void stop();
+
+	///<summary>Releases previously received block and blocks current process until the next block is filled.</summary>
+	///<remarks>Must be called by single consumer process. Returned block is valid until the next call.</remarks>
+	///<returns>Block of ATMOS_ADC_BLOCK_SIZE samples.</returns>
+	static span<const sample_type> receive();
+
+	///<summary>Releases previously received block and blocks current process until the next block is filled,
+	///         but not longer than timeout.</summary>
+	///<remarks>Same requirements as for receive() apply.</remarks>
+	///<param name="ticks">Timeout in scheduler ticks.</param>
+	///<returns>Block of ATMOS_ADC_BLOCK_SIZE samples, or empty block if timeout expired.</returns>
+	static span<const sample_type> receive_for(process::tick_t ticks);
+
+	///<summary>Returns number of blocks, which were dropped because consumer did not release previous block in time.</summary>
+	static uint16_t overrun_count();
+};
+
+} //namespace atmos
+
+#endif //ATMOS_SUPPORT_ADC
@@ -0,0 +1,121 @@
+#include "../kernel/config.h"
+
+#if ATMOS_SUPPORT_SPI
+
+#include "spi.h"
+
+#include <avr/io.h>
+
+#include "../kernel/interrupt.h"
+#include "../kernel/kernel_lock.h"
+#include "transfer_queue.h"
+
+#if defined(SPI_STC_vect)
+#	define ATMOS_SPI_INTERRUPT_NAME SPI_STC_vect
+#elif defined(SPI_vect)
+#	define ATMOS_SPI_INTERRUPT_NAME SPI_vect
+#else //SPI interrupt name
+static_assert(false, "SPI interrupt is not defined for selected device");
+#endif //SPI interrupt name
+
+//Expands vector name macro before passing it to ATMOS_ISR, which concatenates it.
+#define ATMOS_SPI_ISR(vector) ATMOS_ISR(vector)
+
+namespace
+{
+
+///Batch of SPI transfers submitted by process.
+struct spi_request : atmos::detail::transfer_request<atmos::spi_transfer>
+{
+	spi_request(atmos::span<const atmos::spi_transfer> batch, atmos::spi::chip_select_type select)
+		: transfer_request(batch)
+		, chip_select(select)
+	{
+	}
+
+	atmos::spi::chip_select_type chip_select;
+};
+
+atmos::detail::transfer_queue<spi_request> requests;
+
+///Transfer of current request, which is being executed.
+const atmos::spi_transfer* current_transfer;
+
+///Index of byte of current transfer, which is being transferred.
+uint16_t byte_index;
+
+///<summary>Selects slave and prepares to execute request transfers.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+void start_request(spi_request* request) ATMOS_NONNULL(1);
+void start_request(spi_request* request)
+{
+	current_transfer = request->transfers.begin();
+	byte_index = 0;
+	if(request->chip_select)
+		request->chip_select(true);
+}
+
+///<summary>Starts transmission of the next byte. Completes requests, which have nothing left to transfer,
+///         and starts next requests.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+void transfer_next_byte()
+{
+	auto* request = requests.current();
+	while(request)
+	{
+		for(; current_transfer != request->transfers.end(); ++current_transfer, byte_index = 0)
+		{
+			if(byte_index < current_transfer->size)
+			{
+				auto* tx_data = current_transfer->tx_data;
+				SPDR = tx_data ? tx_data[byte_index] : 0xFF;
+				return;
+			}
+		}
+
+		if(request->chip_select)
+			request->chip_select(false);
+
+		request = requests.complete();
+		if(request)
+			start_request(request);
+	}
+}
+
+} //namespace
+
+namespace atmos
+{
+
+void spi::initialize(uint8_t control, bool double_speed)
+{
+	SPCR = control;
+	SPSR = double_speed ? _BV(SPI2X) : 0;
+}
+
+void spi::transfer(span<const spi_transfer> batch, chip_select_type chip_select)
+{
+	spi_request request(batch, chip_select);
+	atmos::kernel_lock lock;
+	if(requests.push(&request))
+	{
+		start_request(&request);
+		transfer_next_byte();
+	}
+
+	requests.wait(&request);
+}
+
+} //namespace atmos
+
+ATMOS_SPI_ISR(ATMOS_SPI_INTERRUPT_NAME)
+{
+	uint8_t value = SPDR;
+	if(auto* rx_data = current_transfer->rx_data)
+		rx_data[byte_index] = value;
+
+	++byte_index;
+	transfer_next_byte();
+}
+
+#endif //ATMOS_SUPPORT_SPI
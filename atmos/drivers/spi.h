@@ -0,0 +1,91 @@
+#pragma once
+
+#include <avr/io.h>
+#include <stdint.h>
+
+#include "../kernel/config.h"
+
+#if ATMOS_SUPPORT_SPI
+
+#include "../kernel/span.h"
+#include "../kernel/static_class.h"
+
+#if !ATMOS_SUPPORT_SLEEP
+static_assert(false, "ATMOS_SUPPORT_SPI requires ATMOS_SUPPORT_SLEEP");
+#endif //!ATMOS_SUPPORT_SLEEP
+
+#if ATMOS_SINGLE_STACK_MODE
+static_assert(false, "ATMOS_SUPPORT_SPI can not be used in single-stack mode");
+#endif //ATMOS_SINGLE_STACK_MODE
+
+#ifndef SPCR
+static_assert(false, "Selected device does not have SPI module");
+#endif //SPCR
+
+namespace atmos
+{
+
+///SPI transfer descriptor.
+struct spi_transfer
+{
+	///Bytes to transmit, or nullptr to transmit 0xFF filler bytes.
+	const uint8_t* tx_data;
+	///Buffer for received bytes, or nullptr to discard received bytes.
+	uint8_t* rx_data;
+	///Number of bytes to transfer.
+	uint16_t size;
+};
+
+///Interrupt-driven SPI master driver. Process submits batch of transfers and sleeps,
+///while SPI interrupt handler chains transfers and wakes up the process when the whole batch is completed.
+///Batches submitted by several processes are queued and executed in FIFO order without interleaving.
+class spi final : public static_class
+{
+public:
+	///Chip select function type. Called with interrupts disabled (also from interrupt handler),
+	///so it must be short, like setting single port pin.
+	using chip_select_type = void(*)(bool selected);
+
+public:
+	///<summary>Initializes SPI in master mode, MSB first.</summary>
+	///<remarks>Must be called before kernel::run() or with interrupts disabled. SCK, MOSI and SS pins
+	///must be configured as outputs by caller, otherwise SPI may leave master mode.</remarks>
+	///<typeparam name="ClockRate">Maximal SCK frequency in Hz. The highest frequency not exceeding this value is chosen.</typeparam>
+	///<typeparam name="Mode">SPI mode (0 to 3): clock polarity and phase.</typeparam>
+	template<uint32_t ClockRate, uint8_t Mode = 0>
+	static void initialize()
+	{
+		static_assert(Mode <= 3, "SPI mode must be 0 to 3");
+		static_assert(ClockRate * 128ull >= F_CPU, "ClockRate is too low for current F_CPU");
+		constexpr uint8_t divider_log2 = get_divider_log2(ClockRate);
+		//Dividers 2, 8, 32 (double speed) and 4, 16, 64 map to SPR1:SPR0 values 0 to 2, divider 128 maps to 3.
+		constexpr bool double_speed = divider_log2 != 7 && divider_log2 % 2;
+		constexpr uint8_t rate = divider_log2 == 7 ? 3 : (divider_log2 - 1) / 2;
+		initialize(static_cast<uint8_t>(_BV(SPIE) | _BV(SPE) | _BV(MSTR)
+			| (Mode << CPHA) | rate), double_speed);
+	}
+
+	///<summary>Executes batch of transfers and blocks current process until it is completed.</summary>
+	///<remarks>Transfer descriptors and buffers must not be changed until function returns.</remarks>
+	///<param name="batch">Transfers to execute in order.</param>
+	///<param name="chip_select">Function, which is called to select slave before first transfer of batch
+	///                          and to deselect it after the last one. Can be nullptr.</param>
+	static void transfer(span<const spi_transfer> batch, chip_select_type chip_select = nullptr);
+
+private:
+	///<summary>Returns base-2 logarithm of the smallest SCK divider giving frequency not higher than clock_rate.</summary>
+	static constexpr uint8_t get_divider_log2(uint32_t clock_rate, uint8_t divider_log2 = 1)
+	{
+		return divider_log2 == 7 || (static_cast<uint32_t>(F_CPU) >> divider_log2) <= clock_rate
+			? divider_log2 : get_divider_log2(clock_rate, divider_log2 + 1);
+	}
+
+	///<summary>Initializes SPI.</summary>
+	///<param name="control">SPCR register value.</param>
+	///<param name="double_speed">Double SPI speed bit value.</param>
+	static void initialize(uint8_t control, bool double_speed);
+};
+
+} //namespace atmos
+
+#endif //ATMOS_SUPPORT_SPI
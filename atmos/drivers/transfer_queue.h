@@ -0,0 +1,137 @@
+#pragma once
+
+#include "../kernel/config.h"
+
+#if ATMOS_SUPPORT_SLEEP
+
+#include "../kernel/defines.h"
+#include "../kernel/forward_list.h"
+#include "../kernel/noncopyable.h"
+#include "../kernel/process.h"
+#include "../kernel/span.h"
+#include "../kernel/wait_list.h"
+
+namespace atmos
+{
+namespace detail
+{
+
+struct transfer_request_list_tag;
+
+///Batch of bus transfers submitted by process. Lives on the stack of submitting process
+///until batch is completed.
+///<typeparam name="Transfer">Transfer descriptor type.</typeparam>
+template<typename Transfer>
+struct transfer_request : container::forward_list_element_tagged<transfer_request_list_tag, transfer_request<Transfer>>
+{
+	///<summary>Creates request.</summary>
+	///<param name="batch">Transfers to execute in order.</param>
+	explicit transfer_request(span<const Transfer> batch)
+		: transfers(batch)
+	{
+	}
+
+	span<const Transfer> transfers;
+	///Set by interrupt handler when all transfers are completed or batch is aborted.
+	bool done = false;
+	///Submitter of request.
+	wait_list submitter;
+};
+
+///FIFO queue of transfer requests, shared by bus interrupt handler and submitting processes.
+///Submitting process sleeps until its request is completed. Interrupt handler chains transfers of
+///the current request and starts the next request right after the current one is completed,
+///without waking up any process in between.
+///<typeparam name="Request">Request type. Must be derived from transfer_request.</typeparam>
+template<typename Request>
+class transfer_queue : public nonmovable
+{
+public:
+	///<summary>Adds request to the end of queue.</summary>
+	///<remarks>Expects that interrupts are disabled.</remarks>
+	///<param name="request">Request not attached to any queue. Can not be nullptr.</param>
+	///<returns>True if bus is idle, and request must be started by caller.</returns>
+	bool push(Request* request) ATMOS_NONNULL(2)
+	{
+		typename Request::list_element_type* elem = request;
+		request_list::set_next(elem, nullptr);
+		if(last_)
+			request_list::set_next(last_, elem);
+		else
+			requests_.push_front(elem);
+
+		last_ = elem;
+		return requests_.first() == elem;
+	}
+
+	///<summary>Blocks current process until request is completed.</summary>
+	///<remarks>Expects that interrupts are disabled (see wait_list::wait).</remarks>
+	///<param name="request">Submitted request. Can not be nullptr.</param>
+	void wait(Request* request) ATMOS_NONNULL(2)
+	{
+		request->submitter.wait([request] { return request->done; });
+	}
+
+	///<summary>Blocks current process until request is completed, but not longer than timeout.</summary>
+	///<remarks>Expects that interrupts are disabled (see wait_list::wait_for). If timeout expires, request
+	///must be removed from queue (see remove) or aborted by caller before it goes out of scope.</remarks>
+	///<param name="request">Submitted request. Can not be nullptr.</param>
+	///<param name="ticks">Timeout in scheduler ticks.</param>
+	///<returns>True if request was completed, false if timeout expired.</returns>
+	bool wait_for(Request* request, process::tick_t ticks) ATMOS_NONNULL(2)
+	{
+		//Request may be completed after timeout expiry, but before submitter is run.
+		request->submitter.wait_for(ticks, [request] { return request->done; });
+		return request->done;
+	}
+
+	///<summary>Removes request, which is queued, but is not started yet.</summary>
+	///<remarks>Expects that interrupts are disabled.</remarks>
+	///<param name="request">Queued request, which is not current request. Can not be nullptr.</param>
+	void remove(Request* request) ATMOS_NONNULL(2)
+	{
+		typename Request::list_element_type* elem = request;
+		auto* prev = requests_.first();
+		while(request_list::next(prev) != elem)
+			prev = request_list::next(prev);
+
+		request_list::set_next(prev, request_list::next(elem));
+		if(last_ == elem)
+			last_ = prev;
+	}
+
+	///<summary>Returns request which is being transferred.</summary>
+	///<returns>Current request or nullptr if bus is idle.</returns>
+	Request* current()
+	{
+		auto* elem = requests_.first();
+		return elem ? static_cast<Request*>(elem) : nullptr;
+	}
+
+	///<summary>Completes current request and wakes up its submitter.</summary>
+	///<remarks>Expects that interrupts are disabled and queue is not empty.</remarks>
+	///<returns>Next request to start, or nullptr if queue is empty.</returns>
+	Request* complete()
+	{
+		auto* elem = requests_.pop_front();
+		if(elem == last_)
+			last_ = nullptr;
+
+		auto* request = static_cast<Request*>(elem);
+		request->done = true;
+		request->submitter.notify_one();
+		return current();
+	}
+
+private:
+	using request_list = container::forward_list_tagged<typename Request::list_element_type>;
+
+	request_list requests_;
+	///Last queued request, or nullptr if queue is empty.
+	typename Request::list_element_type* last_ = nullptr;
+};
+
+} //namespace detail
+} //namespace atmos
+
+#endif //ATMOS_SUPPORT_SLEEP
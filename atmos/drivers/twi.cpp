@@ -0,0 +1,213 @@
+#include "../kernel/config.h"
+
+#if ATMOS_SUPPORT_TWI
+
+#include "twi.h"
+
+#include <avr/io.h>
+
+#include "../kernel/interrupt.h"
+#include "../kernel/kernel_lock.h"
+#include "transfer_queue.h"
+
+namespace
+{
+
+//TWI status codes (TWSR with prescaler bits masked).
+constexpr uint8_t status_mask = 0xF8;
+constexpr uint8_t status_start = 0x08;
+constexpr uint8_t status_repeated_start = 0x10;
+constexpr uint8_t status_address_write_ack = 0x18;
+constexpr uint8_t status_data_write_ack = 0x28;
+constexpr uint8_t status_address_read_ack = 0x40;
+constexpr uint8_t status_data_read_ack = 0x50;
+constexpr uint8_t status_data_read_nack = 0x58;
+
+//TWCR register values.
+constexpr uint8_t control_start = _BV(TWINT) | _BV(TWSTA) | _BV(TWEN) | _BV(TWIE);
+constexpr uint8_t control_continue = _BV(TWINT) | _BV(TWEN) | _BV(TWIE);
+constexpr uint8_t control_continue_ack = _BV(TWINT) | _BV(TWEA) | _BV(TWEN) | _BV(TWIE);
+constexpr uint8_t control_stop = _BV(TWINT) | _BV(TWSTO) | _BV(TWEN);
+
+///Batch of TWI transfers submitted by process.
+struct twi_request : atmos::detail::transfer_request<atmos::twi_transfer>
+{
+	using transfer_request::transfer_request;
+
+	///Set to false, if batch was aborted.
+	bool succeeded = true;
+};
+
+atmos::detail::transfer_queue<twi_request> requests;
+
+///Transfer of current request, which is being executed.
+const atmos::twi_transfer* current_transfer;
+
+///Index of byte of current transfer, which is being written or read.
+uint8_t byte_index;
+
+///True if current transfer is in read phase.
+bool reading;
+
+///<summary>Generates START condition for the next transfer. Completes requests, which have nothing left
+///         to transfer, and releases bus if there are no more requests.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+///<param name="extra_control">Additional TWCR bits (TWSTO to generate STOP condition before START).</param>
+void start_next_transfer(uint8_t extra_control)
+{
+	auto* request = requests.current();
+	while(request && current_transfer == request->transfers.end())
+	{
+		request = requests.complete();
+		if(request)
+			current_transfer = request->transfers.begin();
+	}
+
+	reading = false;
+	TWCR = request ? (control_start | extra_control) : control_stop;
+}
+
+///<summary>Aborts current request and starts the next one.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+void abort_request()
+{
+	auto* request = requests.current();
+	request->succeeded = false;
+	current_transfer = request->transfers.end();
+	start_next_transfer(_BV(TWSTO));
+}
+
+///<summary>Adds request to queue and starts it, if bus is idle.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+///<param name="request">Request not attached to any queue. Can not be nullptr.</param>
+void submit_request(twi_request* request) ATMOS_NONNULL(1);
+void submit_request(twi_request* request)
+{
+	if(!requests.push(request))
+		return;
+
+	//Previous STOP condition takes several SCL periods.
+	while(TWCR & _BV(TWSTO))
+	{
+	}
+
+	current_transfer = request->transfers.begin();
+	start_next_transfer(0);
+}
+
+///<summary>Acknowledges received byte, if more bytes are to be read, or not acknowledges the last byte.</summary>
+void ATMOS_ALWAYS_INLINE continue_reading()
+{
+	TWCR = byte_index + 1 < current_transfer->read_size ? control_continue_ack : control_continue;
+}
+
+} //namespace
+
+namespace atmos
+{
+
+void twi::initialize(uint8_t bit_rate, uint8_t prescaler)
+{
+	TWBR = bit_rate;
+	TWSR = prescaler;
+	TWCR = _BV(TWEN);
+}
+
+bool twi::transfer(span<const twi_transfer> batch)
+{
+	twi_request request(batch);
+	atmos::kernel_lock lock;
+	submit_request(&request);
+	requests.wait(&request);
+	return request.succeeded;
+}
+
+bool twi::transfer_for(span<const twi_transfer> batch, process::tick_t ticks)
+{
+	twi_request request(batch);
+	atmos::kernel_lock lock;
+	submit_request(&request);
+	if(requests.wait_for(&request, ticks))
+		return request.succeeded;
+
+	if(requests.current() == &request)
+	{
+		//Bus is stuck, for example, slave holds SCL line low. Disabling TWI module releases bus lines
+		//and resets its state, then the next request is started.
+		TWCR = 0;
+		abort_request();
+	}
+	else
+	{
+		requests.remove(&request);
+	}
+
+	return false;
+}
+
+} //namespace atmos
+
+ATMOS_ISR(TWI_vect)
+{
+	switch(TWSR & status_mask)
+	{
+	case status_start:
+	case status_repeated_start:
+		//Transfer without data writes address only (checks slave presence).
+		if(!reading && (current_transfer->write_size || !current_transfer->read_size))
+		{
+			TWDR = static_cast<uint8_t>(current_transfer->address << 1);
+		}
+		else
+		{
+			reading = true;
+			TWDR = static_cast<uint8_t>((current_transfer->address << 1) | 1);
+		}
+
+		byte_index = 0;
+		TWCR = control_continue;
+		break;
+
+	case status_address_write_ack:
+	case status_data_write_ack:
+		if(byte_index < current_transfer->write_size)
+		{
+			TWDR = current_transfer->write_data[byte_index++];
+			TWCR = control_continue;
+		}
+		else if(current_transfer->read_size)
+		{
+			//Repeated START to switch to read phase.
+			reading = true;
+			TWCR = control_start;
+		}
+		else
+		{
+			++current_transfer;
+			start_next_transfer(0);
+		}
+		break;
+
+	case status_address_read_ack:
+		continue_reading();
+		break;
+
+	case status_data_read_ack:
+		current_transfer->read_data[byte_index++] = TWDR;
+		continue_reading();
+		break;
+
+	case status_data_read_nack:
+		current_transfer->read_data[byte_index] = TWDR;
+		++current_transfer;
+		start_next_transfer(0);
+		break;
+
+	default:
+		//Address or data was not acknowledged, arbitration was lost, or bus error occurred.
+		abort_request();
+		break;
+	}
+}
+
+#endif //ATMOS_SUPPORT_TWI
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <avr/io.h>
+#include <stdint.h>
+
+#include "../kernel/config.h"
+
+#if ATMOS_SUPPORT_TWI
+
+#include "../kernel/process.h"
+#include "../kernel/span.h"
+#include "../kernel/static_class.h"
+
+#if !ATMOS_SUPPORT_SLEEP
+static_assert(false, "ATMOS_SUPPORT_TWI requires ATMOS_SUPPORT_SLEEP");
+#endif //!ATMOS_SUPPORT_SLEEP
+
+#if ATMOS_SINGLE_STACK_MODE
+static_assert(false, "ATMOS_SUPPORT_TWI can not be used in single-stack mode");
+#endif //ATMOS_SINGLE_STACK_MODE
+
+#ifndef TWBR
+static_assert(false, "Selected device does not have TWI master module");
+#endif //TWBR
+
+namespace atmos
+{
+
+///TWI (I2C) transfer descriptor. Transfer writes bytes to slave, then reads bytes from slave
+///after repeated START condition, for example, writes register address and reads register value.
+struct twi_transfer
+{
+	///7-bit slave address.
+	uint8_t address;
+	///Number of bytes to write. Can be zero. If both write_size and read_size are zero,
+	///only slave address is written, which checks slave presence.
+	uint8_t write_size;
+	///Number of bytes to read. Can be zero.
+	uint8_t read_size;
+	///Bytes to write.
+	const uint8_t* write_data;
+	///Buffer for read bytes.
+	uint8_t* read_data;
+};
+
+///Interrupt-driven TWI (I2C) master driver. Process submits batch of transfers and sleeps,
+///while TWI interrupt handler chains transfers (with repeated START conditions) and wakes up the process
+///when the whole batch is completed. Batches submitted by several processes are queued and executed in FIFO order.
+class twi final : public static_class
+{
+public:
+	///<summary>Initializes TWI module.</summary>
+	///<remarks>Must be called before kernel::run() or with interrupts disabled.</remarks>
+	///<typeparam name="ClockRate">Maximal SCL frequency in Hz. The highest frequency not exceeding this value is chosen.</typeparam>
+	template<uint32_t ClockRate>
+	static void initialize()
+	{
+		static_assert(ClockRate > 0 && F_CPU / ClockRate > 16, "ClockRate is too high for current F_CPU");
+		constexpr uint8_t prescaler = get_prescaler(ClockRate);
+		static_assert(prescaler < 4, "ClockRate is too low for current F_CPU");
+		initialize(static_cast<uint8_t>(get_bit_rate(ClockRate, prescaler)), prescaler);
+	}
+
+	///<summary>Executes batch of transfers and blocks current process until it is completed.</summary>
+	///<remarks>Transfer descriptors and buffers must not be changed until function returns.
+	///Batch is aborted, if slave does not acknowledge address or written byte, or if bus arbitration is lost.</remarks>
+	///<param name="batch">Transfers to execute in order.</param>
+	///<returns>True if all transfers were completed, false if batch was aborted.</returns>
+	static bool transfer(span<const twi_transfer> batch);
+
+	///<summary>Executes batch of transfers and blocks current process until it is completed,
+	///         but not longer than timeout.</summary>
+	///<remarks>Same requirements as for transfer() apply. If timeout expires while batch is being transferred,
+	///TWI module is reset, which releases bus lines, for example, when slave holds SCL line low.</remarks>
+	///<param name="batch">Transfers to execute in order.</param>
+	///<param name="ticks">Timeout in scheduler ticks, including time batch waits for previous batches.</param>
+	///<returns>True if all transfers were completed, false if batch was aborted or timeout expired.</returns>
+	static bool transfer_for(span<const twi_transfer> batch, process::tick_t ticks);
+
+private:
+	///<summary>Returns bit rate register value for prescaler value, rounded up, so that frequency does not exceed clock_rate.</summary>
+	static constexpr uint32_t get_bit_rate(uint32_t clock_rate, uint8_t prescaler)
+	{
+		//SCL frequency = F_CPU / (16 + 2 * TWBR * 4^prescaler).
+		return ((F_CPU + clock_rate - 1) / clock_rate - 16 + (2ul << (2 * prescaler)) - 1) / (2ul << (2 * prescaler));
+	}
+
+	///<summary>Returns the smallest prescaler value, for which bit rate register value fits 8 bits.</summary>
+	static constexpr uint8_t get_prescaler(uint32_t clock_rate, uint8_t prescaler = 0)
+	{
+		return prescaler == 4 || get_bit_rate(clock_rate, prescaler) <= UINT8_MAX
+			? prescaler : get_prescaler(clock_rate, prescaler + 1);
+	}
+
+	///<summary>Initializes TWI module.</summary>
+	///<param name="bit_rate">TWBR register value.</param>
+	///<param name="prescaler">Prescaler bits value.</param>
+	static void initialize(uint8_t bit_rate, uint8_t prescaler);
+};
+
+} //namespace atmos
+
+#endif //ATMOS_SUPPORT_TWI
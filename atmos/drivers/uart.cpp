@@ -0,0 +1,365 @@
+#include "../kernel/config.h"
+
+#if ATMOS_SUPPORT_UART
+
+#include "uart.h"
+
+#include <avr/io.h>
+
+#include "../kernel/deadline.h"
+#include "../kernel/interrupt.h"
+#include "../kernel/kernel_lock.h"
+#include "../kernel/wait_list.h"
+#include "uart_selector.h"
+
+static_assert(ATMOS_UART_RX_BUFFER_SIZE && ATMOS_UART_RX_BUFFER_SIZE <= 128
+	&& !(ATMOS_UART_RX_BUFFER_SIZE & (ATMOS_UART_RX_BUFFER_SIZE - 1)),
+	"ATMOS_UART_RX_BUFFER_SIZE must be a power of two not greater than 128");
+static_assert(ATMOS_UART_TX_BUFFER_SIZE && ATMOS_UART_TX_BUFFER_SIZE <= 128
+	&& !(ATMOS_UART_TX_BUFFER_SIZE & (ATMOS_UART_TX_BUFFER_SIZE - 1)),
+	"ATMOS_UART_TX_BUFFER_SIZE must be a power of two not greater than 128");
+
+//Expands vector name macro before passing it to ATMOS_ISR, which concatenates it.
+#define ATMOS_UART_ISR(vector) ATMOS_ISR(vector)
+
+namespace
+{
+
+//UART control and status register bits (the same for all supported MCUs).
+constexpr uint8_t rx_complete_interrupt_enable_bit = 7; //RXCIE
+constexpr uint8_t data_register_empty_interrupt_enable_bit = 5; //UDRIE
+constexpr uint8_t receiver_enable_bit = 4; //RXEN
+constexpr uint8_t transmitter_enable_bit = 3; //TXEN
+constexpr uint8_t double_speed_bit = 1; //U2X
+
+///Process blocked on ring buffer. Lives on the stack of blocked process while it waits.
+struct buffer_waiter
+{
+	///Number of bytes (or free bytes) process needs to continue.
+	uint8_t wanted;
+	buffer_waiter* next;
+};
+
+///Ring buffer, which is filled by one side and drained by another.
+///<typeparam name="Size">Buffer size. Must be a power of two not greater than 128.</typeparam>
+template<uint8_t Size>
+struct ring_buffer
+{
+	uint8_t data[Size];
+	///Index of first byte (wraps around).
+	uint8_t head;
+	///Index after last byte (wraps around).
+	uint8_t tail;
+	///Blocked processes in the same order as in wait list, so that interrupt handler
+	///checks what the first blocked process needs.
+	buffer_waiter* first_waiter;
+	buffer_waiter* last_waiter;
+	atmos::wait_list waiters;
+
+	uint8_t count() const
+	{
+		return static_cast<uint8_t>(tail - head);
+	}
+
+	uint8_t free() const
+	{
+		return static_cast<uint8_t>(Size - count());
+	}
+
+	void push(uint8_t value)
+	{
+		data[tail++ & (Size - 1)] = value;
+	}
+
+	uint8_t pop()
+	{
+		return data[head++ & (Size - 1)];
+	}
+
+	///<summary>Blocks current process until buffer has enough bytes (or free bytes) for it.</summary>
+	///<remarks>Expects that interrupts are disabled.</remarks>
+	///<param name="wanted">Number of bytes (or free bytes) process needs to continue.</param>
+	///<param name="available">Functor, which returns number of bytes (or free bytes) in buffer.</param>
+	///<param name="block">Functor, which blocks current process on wait list once.
+	///                    Returns false if timeout expired.</param>
+	///<returns>True if buffer has wanted number of bytes (or free bytes), false if timeout expired.</returns>
+	template<typename Available, typename Block>
+	bool wait(uint8_t wanted, Available&& available, Block&& block)
+	{
+		while(available() < wanted)
+		{
+			//Process is appended to wait list together with its record, so their order is the same.
+			buffer_waiter waiter{ wanted, nullptr };
+			if(last_waiter)
+				last_waiter->next = &waiter;
+			else
+				first_waiter = &waiter;
+			
+			last_waiter = &waiter;
+			//Record is removed by notify_first() when process is notified.
+			if(!block())
+			{
+				remove_waiter(&waiter);
+				//Next blocked process may need less than this one.
+				notify_first(available());
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	///<summary>Wakes up first blocked process, if buffer has enough bytes (or free bytes) for it.</summary>
+	///<remarks>Expects that interrupts are disabled. Can be called from ISR.</remarks>
+	///<param name="available">Number of bytes (or free bytes) in buffer.</param>
+	void notify_first(uint8_t available)
+	{
+		auto* waiter = first_waiter;
+		if(!waiter || available < waiter->wanted)
+			return;
+
+		first_waiter = waiter->next;
+		if(!first_waiter)
+			last_waiter = nullptr;
+
+		waiters.notify_one();
+	}
+
+	///<summary>Removes record of process, whose timeout has expired.</summary>
+	///<remarks>Expects that interrupts are disabled.</remarks>
+	///<param name="waiter">Record contained in the list of blocked processes.</param>
+	void remove_waiter(buffer_waiter* waiter)
+	{
+		buffer_waiter* prev = nullptr;
+		for(auto* current = first_waiter; current != waiter; current = current->next)
+			prev = current;
+
+		if(prev)
+			prev->next = waiter->next;
+		else
+			first_waiter = waiter->next;
+
+		if(last_waiter == waiter)
+			last_waiter = prev;
+	}
+};
+
+ring_buffer<ATMOS_UART_RX_BUFFER_SIZE> rx_buffer;
+ring_buffer<ATMOS_UART_TX_BUFFER_SIZE> tx_buffer;
+
+///<summary>Returns the smaller of two values.</summary>
+uint8_t min_size(size_t a, uint8_t b)
+{
+	return a < b ? static_cast<uint8_t>(a) : b;
+}
+
+///<summary>Enables data register empty interrupt, which drains transmit buffer.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+void ATMOS_ALWAYS_INLINE start_transmission()
+{
+	ATMOS_UART_CONTROL |= _BV(data_register_empty_interrupt_enable_bit);
+}
+
+///<summary>Returns number of bytes in receive buffer.</summary>
+uint8_t rx_available()
+{
+	return rx_buffer.count();
+}
+
+///<summary>Returns number of free bytes in transmit buffer.</summary>
+uint8_t tx_available()
+{
+	return tx_buffer.free();
+}
+
+///<summary>Places bytes into transmit buffer.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+///<param name="data">Bytes to transmit.</param>
+///<param name="block">Functor, which blocks current process on wait list once. Returns false if timeout expired.</param>
+///<returns>Number of bytes placed into transmit buffer.</returns>
+template<typename Block>
+size_t write_bytes(atmos::span<const uint8_t> data, Block&& block)
+{
+	auto* source = data.begin();
+	auto* end = data.end();
+	bool completed = true;
+	while(source != end && completed)
+	{
+		//Wait for at least half of the buffer to become free, so that
+		//writer is woken up once per buffer half, not once per byte.
+		//On timeout, buffer is still filled as much as possible.
+		completed = tx_buffer.wait(min_size(end - source, ATMOS_UART_TX_BUFFER_SIZE / 2), tx_available, block);
+
+		for(auto count = min_size(end - source, tx_buffer.free()); count; --count)
+			tx_buffer.push(*source++);
+
+		start_transmission();
+	}
+
+	return static_cast<size_t>(source - data.begin());
+}
+
+///<summary>Takes bytes from receive buffer.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+///<param name="data">Buffer to store received bytes to.</param>
+///<param name="block">Functor, which blocks current process on wait list once. Returns false if timeout expired.</param>
+///<returns>Number of bytes stored.</returns>
+template<typename Block>
+size_t read_bytes(atmos::span<uint8_t> data, Block&& block)
+{
+	auto* target = data.begin();
+	auto* end = data.end();
+	bool completed = true;
+	while(target != end && completed)
+	{
+		//Wait for the rest of data, but not more than half of the buffer,
+		//so that buffer is drained before it overflows.
+		//On timeout, bytes received so far are still taken.
+		completed = rx_buffer.wait(min_size(end - target, ATMOS_UART_RX_BUFFER_SIZE / 2), rx_available, block);
+
+		for(auto count = min_size(end - target, rx_buffer.count()); count; --count)
+			*target++ = rx_buffer.pop();
+	}
+
+	//Bytes left in buffer may be enough for the next blocked reader.
+	rx_buffer.notify_first(rx_buffer.count());
+	return static_cast<size_t>(target - data.begin());
+}
+
+///<summary>Blocks current process on transmit buffer wait list once.</summary>
+///<returns>Always true.</returns>
+bool block_tx()
+{
+	tx_buffer.waiters.wait();
+	return true;
+}
+
+///<summary>Blocks current process on receive buffer wait list once.</summary>
+///<returns>Always true.</returns>
+bool block_rx()
+{
+	rx_buffer.waiters.wait();
+	return true;
+}
+
+} //namespace
+
+namespace atmos
+{
+
+void uart::initialize(uint16_t baud_rate_register)
+{
+	ATMOS_UART_CONTROL = 0;
+	ATMOS_UART_BAUD_HIGH = static_cast<uint8_t>(baud_rate_register >> 8);
+	ATMOS_UART_BAUD_LOW = static_cast<uint8_t>(baud_rate_register);
+	ATMOS_UART_STATUS = _BV(double_speed_bit);
+	ATMOS_UART_CONTROL = _BV(rx_complete_interrupt_enable_bit)
+		| _BV(receiver_enable_bit) | _BV(transmitter_enable_bit);
+}
+
+void uart::write(uint8_t value)
+{
+	write(span<const uint8_t>(&value, 1));
+}
+
+void uart::write(span<const uint8_t> data)
+{
+	atmos::kernel_lock lock;
+	write_bytes(data, block_tx);
+}
+
+bool uart::write_for(uint8_t value, process::tick_t ticks)
+{
+	return write_for(span<const uint8_t>(&value, 1), ticks) != 0;
+}
+
+size_t uart::write_for(span<const uint8_t> data, process::tick_t ticks)
+{
+	atmos::kernel_lock lock;
+	deadline time_limit(ticks);
+	return write_bytes(data, [&time_limit]
+	{
+		return tx_buffer.waiters.wait_for(time_limit.remaining());
+	});
+}
+
+uint8_t uart::read()
+{
+	uint8_t value;
+	read(span<uint8_t>(&value, 1));
+	return value;
+}
+
+void uart::read(span<uint8_t> data)
+{
+	atmos::kernel_lock lock;
+	read_bytes(data, block_rx);
+}
+
+bool uart::read_for(uint8_t& value, process::tick_t ticks)
+{
+	return read_for(span<uint8_t>(&value, 1), ticks) != 0;
+}
+
+size_t uart::read_for(span<uint8_t> data, process::tick_t ticks)
+{
+	atmos::kernel_lock lock;
+	deadline time_limit(ticks);
+	return read_bytes(data, [&time_limit]
+	{
+		return rx_buffer.waiters.wait_for(time_limit.remaining());
+	});
+}
+
+bool uart::try_read(uint8_t& value)
+{
+	atmos::kernel_lock lock;
+	if(!rx_buffer.count())
+		return false;
+
+	value = rx_buffer.pop();
+	return true;
+}
+
+void uart::flush()
+{
+	atmos::kernel_lock lock;
+	//Transmit buffer is empty, when all its bytes are free.
+	tx_buffer.wait(ATMOS_UART_TX_BUFFER_SIZE, tx_available, block_tx);
+}
+
+bool uart::flush_for(process::tick_t ticks)
+{
+	atmos::kernel_lock lock;
+	deadline time_limit(ticks);
+	return tx_buffer.wait(ATMOS_UART_TX_BUFFER_SIZE, tx_available, [&time_limit]
+	{
+		return tx_buffer.waiters.wait_for(time_limit.remaining());
+	});
+}
+
+} //namespace atmos
+
+ATMOS_UART_ISR(ATMOS_UART_RX_INTERRUPT_NAME)
+{
+	uint8_t value = ATMOS_UART_DATA;
+	if(!rx_buffer.free())
+		return;
+
+	rx_buffer.push(value);
+	rx_buffer.notify_first(rx_buffer.count());
+}
+
+ATMOS_UART_ISR(ATMOS_UART_UDRE_INTERRUPT_NAME)
+{
+	if(!tx_buffer.count())
+	{
+		ATMOS_UART_CONTROL &= static_cast<uint8_t>(~_BV(data_register_empty_interrupt_enable_bit));
+		return;
+	}
+
+	ATMOS_UART_DATA = tx_buffer.pop();
+	tx_buffer.notify_first(tx_buffer.free());
+}
+
+#endif //ATMOS_SUPPORT_UART
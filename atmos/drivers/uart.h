@@ -0,0 +1,120 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "../kernel/config.h"
+
+#if ATMOS_SUPPORT_UART
+
+#include "../kernel/process.h"
+#include "../kernel/span.h"
+#include "../kernel/static_class.h"
+
+#if !ATMOS_SUPPORT_SLEEP
+static_assert(false, "ATMOS_SUPPORT_UART requires ATMOS_SUPPORT_SLEEP");
+#endif //!ATMOS_SUPPORT_SLEEP
+
+#if ATMOS_SINGLE_STACK_MODE
+static_assert(false, "ATMOS_SUPPORT_UART can not be used in single-stack mode");
+#endif //ATMOS_SINGLE_STACK_MODE
+
+#ifndef F_CPU
+static_assert(false, "You need to have F_CPU value defined");
+#endif //F_CPU
+
+namespace atmos
+{
+
+///Interrupt-driven UART driver (see ATMOS_UART_INDEX). Bytes are transmitted and received through
+///ring buffers, which are fed by UART interrupts. Writing process is blocked while transmit buffer is full,
+///and reading process is blocked while receive buffer does not contain requested data. Processes are woken up
+///from interrupt handlers, and for bulk transfers only when enough buffer space or data is available,
+///so that there is one context switch per buffer half instead of one per byte. Each blocked process is woken up
+///only when buffer has enough data or space for it, and blocked processes are served in FIFO order.
+///Writes from several processes are not interleaved byte-by-byte, but may be interleaved at buffer boundaries.
+///Received bytes are dropped, if receive buffer is full.
+class uart final : public static_class
+{
+public:
+	///<summary>Initializes UART and enables receiver and transmitter.
+	///         Uses double speed mode and 8N1 frame format.</summary>
+	///<remarks>Must be called before kernel::run() or with interrupts disabled.</remarks>
+	///<typeparam name="BaudRate">Baud rate. Baud rate error must not exceed 2.5%.</typeparam>
+	template<uint32_t BaudRate>
+	static void initialize()
+	{
+		static_assert(BaudRate > 0, "BaudRate must be positive");
+		constexpr uint32_t divisor = (F_CPU + 4 * BaudRate) / (8 * BaudRate);
+		static_assert(divisor >= 1 && divisor <= 4096, "BaudRate can not be achieved with current F_CPU");
+		constexpr uint32_t actual_baud_rate = F_CPU / (8 * divisor);
+		constexpr uint32_t error = actual_baud_rate > BaudRate
+			? actual_baud_rate - BaudRate : BaudRate - actual_baud_rate;
+		static_assert(error * 40 <= BaudRate, "BaudRate error exceeds 2.5% with current F_CPU");
+		initialize(static_cast<uint16_t>(divisor - 1));
+	}
+
+	///<summary>Writes byte. Blocks current process while transmit buffer is full.</summary>
+	///<param name="value">Byte to transmit.</param>
+	static void write(uint8_t value);
+
+	///<summary>Writes bytes. Blocks current process until all bytes are placed into transmit buffer.</summary>
+	///<param name="data">Bytes to transmit.</param>
+	static void write(span<const uint8_t> data);
+
+	///<summary>Writes byte. Blocks current process while transmit buffer is full, but not longer than timeout.</summary>
+	///<param name="value">Byte to transmit.</param>
+	///<param name="ticks">Timeout in scheduler ticks.</param>
+	///<returns>True if byte was placed into transmit buffer, false if timeout expired.</returns>
+	static bool write_for(uint8_t value, process::tick_t ticks);
+
+	///<summary>Writes bytes. Blocks current process until all bytes are placed into transmit buffer,
+	///         but not longer than timeout.</summary>
+	///<param name="data">Bytes to transmit.</param>
+	///<param name="ticks">Timeout in scheduler ticks for the whole data.</param>
+	///<returns>Number of bytes placed into transmit buffer. Less than data size, if timeout expired.</returns>
+	static size_t write_for(span<const uint8_t> data, process::tick_t ticks);
+
+	///<summary>Reads byte. Blocks current process while receive buffer is empty.</summary>
+	///<returns>Received byte.</returns>
+	static uint8_t read();
+
+	///<summary>Reads bytes. Blocks current process until data is filled completely.</summary>
+	///<param name="data">Buffer to store received bytes to.</param>
+	static void read(span<uint8_t> data);
+
+	///<summary>Reads byte. Blocks current process while receive buffer is empty, but not longer than timeout.</summary>
+	///<param name="value">Received byte.</param>
+	///<param name="ticks">Timeout in scheduler ticks.</param>
+	///<returns>True if byte was read, false if timeout expired.</returns>
+	static bool read_for(uint8_t& value, process::tick_t ticks);
+
+	///<summary>Reads bytes. Blocks current process until data is filled completely, but not longer than timeout.</summary>
+	///<param name="data">Buffer to store received bytes to.</param>
+	///<param name="ticks">Timeout in scheduler ticks for the whole data.</param>
+	///<returns>Number of bytes read. Less than data size, if timeout expired.</returns>
+	static size_t read_for(span<uint8_t> data, process::tick_t ticks);
+
+	///<summary>Reads byte, if receive buffer is not empty.</summary>
+	///<remarks>Can be called from ISR.</remarks>
+	///<param name="value">Received byte.</param>
+	///<returns>True if byte was read, false if receive buffer is empty.</returns>
+	static bool try_read(uint8_t& value);
+
+	///<summary>Blocks current process until transmit buffer is empty.</summary>
+	///<remarks>Last byte may still be shifted out by UART on return.</remarks>
+	static void flush();
+
+	///<summary>Blocks current process until transmit buffer is empty, but not longer than timeout.</summary>
+	///<param name="ticks">Timeout in scheduler ticks.</param>
+	///<returns>True if transmit buffer is empty, false if timeout expired.</returns>
+	static bool flush_for(process::tick_t ticks);
+
+private:
+	///<summary>Initializes UART.</summary>
+	///<param name="baud_rate_register">UBRR register value for double speed mode.</param>
+	static void initialize(uint16_t baud_rate_register);
+};
+
+} //namespace atmos
+
+#endif //ATMOS_SUPPORT_UART
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <avr/io.h>
+
+/** \file UART configuration macros definitions for supported MCUs.
+ *  "x" below is a UART (USART) number.
+ *  ATMOS_UARTx_DATA - UART data register (UDR).
+ *  ATMOS_UARTx_STATUS - UART control and status register A (UCSRA), which contains RXC, UDRE and U2X bits.
+ *  ATMOS_UARTx_CONTROL - UART control and status register B (UCSRB), which contains interrupt and receiver/transmitter enable bits.
+ *  ATMOS_UARTx_BAUD_HIGH - high byte of UART baud rate register (UBRRH).
+ *  ATMOS_UARTx_BAUD_LOW - low byte of UART baud rate register (UBRRL).
+ *  ATMOS_UARTx_RX_INTERRUPT_NAME - UART receive complete interrupt name.
+ *  ATMOS_UARTx_UDRE_INTERRUPT_NAME - UART data register empty interrupt name.
+ *  Bit positions in control and status registers are the same for all supported MCUs (see uart.cpp).
+ *  UCSRC register is not touched, so UART uses default 8N1 frame format. */
+
+#if defined(__AVR_ATmega8A__) || defined(__AVR_ATmega8__) \
+	|| defined(__AVR_ATmega16__) || defined(__AVR_ATmega16A__) \
+	|| defined(__AVR_ATmega32__) || defined(__AVR_ATmega32A__)
+
+#	define ATMOS_UART0_DATA UDR
+#	define ATMOS_UART0_STATUS UCSRA
+#	define ATMOS_UART0_CONTROL UCSRB
+#	define ATMOS_UART0_BAUD_HIGH UBRRH
+#	define ATMOS_UART0_BAUD_LOW UBRRL
+#	define ATMOS_UART0_RX_INTERRUPT_NAME USART_RXC_vect
+#	define ATMOS_UART0_UDRE_INTERRUPT_NAME USART_UDRE_vect
+
+#elif defined(__AVR_ATmega8515__) || defined(__AVR_ATmega8535__) \
+	|| defined(__AVR_ATtiny2313__) || defined(__AVR_ATtiny2313A__) || defined(__AVR_ATtiny4313__)
+
+#	define ATMOS_UART0_DATA UDR
+#	define ATMOS_UART0_STATUS UCSRA
+#	define ATMOS_UART0_CONTROL UCSRB
+#	define ATMOS_UART0_BAUD_HIGH UBRRH
+#	define ATMOS_UART0_BAUD_LOW UBRRL
+#	define ATMOS_UART0_RX_INTERRUPT_NAME USART_RX_vect
+#	define ATMOS_UART0_UDRE_INTERRUPT_NAME USART_UDRE_vect
+
+#elif defined(__AVR_ATmega64__) || defined(__AVR_ATmega64A__) \
+	|| defined(__AVR_ATmega128__) || defined(__AVR_ATmega128A__) \
+	|| defined(__AVR_ATtiny441__) || defined(__AVR_ATtiny841__)
+
+#	define ATMOS_UART0_DATA UDR0
+#	define ATMOS_UART0_STATUS UCSR0A
+#	define ATMOS_UART0_CONTROL UCSR0B
+#	define ATMOS_UART0_BAUD_HIGH UBRR0H
+#	define ATMOS_UART0_BAUD_LOW UBRR0L
+#	define ATMOS_UART0_RX_INTERRUPT_NAME USART0_RX_vect
+#	define ATMOS_UART0_UDRE_INTERRUPT_NAME USART0_UDRE_vect
+
+#	define ATMOS_UART1_DATA UDR1
+#	define ATMOS_UART1_STATUS UCSR1A
+#	define ATMOS_UART1_CONTROL UCSR1B
+#	define ATMOS_UART1_BAUD_HIGH UBRR1H
+#	define ATMOS_UART1_BAUD_LOW UBRR1L
+#	define ATMOS_UART1_RX_INTERRUPT_NAME USART1_RX_vect
+#	define ATMOS_UART1_UDRE_INTERRUPT_NAME USART1_UDRE_vect
+
+#elif defined(__AVR_ATmega162__)
+
+#	define ATMOS_UART0_DATA UDR0
+#	define ATMOS_UART0_STATUS UCSR0A
+#	define ATMOS_UART0_CONTROL UCSR0B
+#	define ATMOS_UART0_BAUD_HIGH UBRR0H
+#	define ATMOS_UART0_BAUD_LOW UBRR0L
+#	define ATMOS_UART0_RX_INTERRUPT_NAME USART0_RXC_vect
+#	define ATMOS_UART0_UDRE_INTERRUPT_NAME USART0_UDRE_vect
+
+#	define ATMOS_UART1_DATA UDR1
+#	define ATMOS_UART1_STATUS UCSR1A
+#	define ATMOS_UART1_CONTROL UCSR1B
+#	define ATMOS_UART1_BAUD_HIGH UBRR1H
+#	define ATMOS_UART1_BAUD_LOW UBRR1L
+#	define ATMOS_UART1_RX_INTERRUPT_NAME USART1_RXC_vect
+#	define ATMOS_UART1_UDRE_INTERRUPT_NAME USART1_UDRE_vect
+
+#elif defined(__AVR_ATmega48__) || defined(__AVR_ATmega88__) || defined(__AVR_ATmega168__) \
+	|| defined(__AVR_ATmega48P__) || defined(__AVR_ATmega88P__) || defined(__AVR_ATmega168P__) \
+	|| defined(__AVR_ATmega48A__) || defined(__AVR_ATmega48PA__) || defined(__AVR_ATmega88A__) || defined(__AVR_ATmega88PA__) \
+	|| defined(__AVR_ATmega168A__) || defined(__AVR_ATmega168PA__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega328P__)
+
+#	define ATMOS_UART0_DATA UDR0
+#	define ATMOS_UART0_STATUS UCSR0A
+#	define ATMOS_UART0_CONTROL UCSR0B
+#	define ATMOS_UART0_BAUD_HIGH UBRR0H
+#	define ATMOS_UART0_BAUD_LOW UBRR0L
+#	define ATMOS_UART0_RX_INTERRUPT_NAME USART_RX_vect
+#	define ATMOS_UART0_UDRE_INTERRUPT_NAME USART_UDRE_vect
+
+#elif defined(__AVR_ATmega164A__) || defined(__AVR_ATmega164PA__) || defined(__AVR_ATmega324A__) || defined(__AVR_ATmega324PA__) \
+	|| defined(__AVR_ATmega644A__) || defined(__AVR_ATmega644PA__) || defined(__AVR_ATmega1284__) || defined(__AVR_ATmega1284P__) \
+	|| defined(__AVR_ATmega164P__) || defined(__AVR_ATmega324P__) || defined(__AVR_ATmega644P__) || defined(__AVR_ATmega644__) \
+	|| defined(__AVR_ATmega640__) || defined(__AVR_ATmega1280__) || defined(__AVR_ATmega1281__) \
+	|| defined(__AVR_ATmega2560__) || defined(__AVR_ATmega2561__)
+
+#	define ATMOS_UART0_DATA UDR0
+#	define ATMOS_UART0_STATUS UCSR0A
+#	define ATMOS_UART0_CONTROL UCSR0B
+#	define ATMOS_UART0_BAUD_HIGH UBRR0H
+#	define ATMOS_UART0_BAUD_LOW UBRR0L
+#	define ATMOS_UART0_RX_INTERRUPT_NAME USART0_RX_vect
+#	define ATMOS_UART0_UDRE_INTERRUPT_NAME USART0_UDRE_vect
+
+#	if !defined(__AVR_ATmega644__)
+
+#		define ATMOS_UART1_DATA UDR1
+#		define ATMOS_UART1_STATUS UCSR1A
+#		define ATMOS_UART1_CONTROL UCSR1B
+#		define ATMOS_UART1_BAUD_HIGH UBRR1H
+#		define ATMOS_UART1_BAUD_LOW UBRR1L
+#		define ATMOS_UART1_RX_INTERRUPT_NAME USART1_RX_vect
+#		define ATMOS_UART1_UDRE_INTERRUPT_NAME USART1_UDRE_vect
+
+#	endif
+
+#	if defined(__AVR_ATmega640__) || defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__)
+
+#		define ATMOS_UART2_DATA UDR2
+#		define ATMOS_UART2_STATUS UCSR2A
+#		define ATMOS_UART2_CONTROL UCSR2B
+#		define ATMOS_UART2_BAUD_HIGH UBRR2H
+#		define ATMOS_UART2_BAUD_LOW UBRR2L
+#		define ATMOS_UART2_RX_INTERRUPT_NAME USART2_RX_vect
+#		define ATMOS_UART2_UDRE_INTERRUPT_NAME USART2_UDRE_vect
+
+#		define ATMOS_UART3_DATA UDR3
+#		define ATMOS_UART3_STATUS UCSR3A
+#		define ATMOS_UART3_CONTROL UCSR3B
+#		define ATMOS_UART3_BAUD_HIGH UBRR3H
+#		define ATMOS_UART3_BAUD_LOW UBRR3L
+#		define ATMOS_UART3_RX_INTERRUPT_NAME USART3_RX_vect
+#		define ATMOS_UART3_UDRE_INTERRUPT_NAME USART3_UDRE_vect
+
+#	endif
+
+#elif defined(__AVR_ATmega8U2__) || defined(__AVR_ATmega16U2__) || defined(__AVR_ATmega32U2__) \
+	|| defined(__AVR_ATmega32U4__) || defined(__AVR_ATmega16U4__)
+
+#	define ATMOS_UART1_DATA UDR1
+#	define ATMOS_UART1_STATUS UCSR1A
+#	define ATMOS_UART1_CONTROL UCSR1B
+#	define ATMOS_UART1_BAUD_HIGH UBRR1H
+#	define ATMOS_UART1_BAUD_LOW UBRR1L
+#	define ATMOS_UART1_RX_INTERRUPT_NAME USART1_RX_vect
+#	define ATMOS_UART1_UDRE_INTERRUPT_NAME USART1_UDRE_vect
+
+#elif defined(__AVR_ATmega165P__) || defined(__AVR_ATmega165A__) || defined(__AVR_ATmega165PA__) \
+	|| defined(__AVR_ATmega325P__) || defined(__AVR_ATmega325A__) || defined(__AVR_ATmega325PA__) \
+	|| defined(__AVR_ATmega3250P__) || defined(__AVR_ATmega3250A__) || defined(__AVR_ATmega3250PA__) \
+	|| defined(__AVR_ATmega645P__) || defined(__AVR_ATmega645A__) \
+	|| defined(__AVR_ATmega6450P__) || defined(__AVR_ATmega6450A__) \
+	|| defined(__AVR_ATmega325__) || defined(__AVR_ATmega3250__) \
+	|| defined(__AVR_ATmega645__) || defined(__AVR_ATmega6450__) \
+	|| defined(__AVR_ATmega169P__) || defined(__AVR_ATmega169A__) || defined(__AVR_ATmega169PA__) \
+	|| defined(__AVR_ATmega329__) || defined(__AVR_ATmega329P__) || defined(__AVR_ATmega329A__) || defined(__AVR_ATmega329PA__) \
+	|| defined(__AVR_ATmega3290__) || defined(__AVR_ATmega3290P__) || defined(__AVR_ATmega3290A__) || defined(__AVR_ATmega3290PA__) \
+	|| defined(__AVR_ATmega649__) || defined(__AVR_ATmega649A__) || defined(__AVR_ATmega649P__) \
+	|| defined(__AVR_ATmega6490__) || defined(__AVR_ATmega6490A__) || defined(__AVR_ATmega6490P__)
+
+#	define ATMOS_UART0_DATA UDR0
+#	define ATMOS_UART0_STATUS UCSR0A
+#	define ATMOS_UART0_CONTROL UCSR0B
+#	define ATMOS_UART0_BAUD_HIGH UBRR0H
+#	define ATMOS_UART0_BAUD_LOW UBRR0L
+#	define ATMOS_UART0_RX_INTERRUPT_NAME USART0_RX_vect
+#	define ATMOS_UART0_UDRE_INTERRUPT_NAME USART0_UDRE_vect
+
+#endif
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "../kernel/config.h"
+#include "uart_config.h"
+
+/** \file Selects UART configuration based on user configuration in config.h.
+ *  Defines general UART configuration macros without the index of UART to use. */
+
+#if ATMOS_UART_INDEX == 0
+#	ifndef ATMOS_UART0_DATA
+static_assert(false, "UART #0 is not available for selected device. Add your device UART configuration to uart_config.h");
+#	endif //ATMOS_UART0_DATA
+#	define ATMOS_UART_DATA ATMOS_UART0_DATA
+#	define ATMOS_UART_STATUS ATMOS_UART0_STATUS
+#	define ATMOS_UART_CONTROL ATMOS_UART0_CONTROL
+#	define ATMOS_UART_BAUD_HIGH ATMOS_UART0_BAUD_HIGH
+#	define ATMOS_UART_BAUD_LOW ATMOS_UART0_BAUD_LOW
+#	define ATMOS_UART_RX_INTERRUPT_NAME ATMOS_UART0_RX_INTERRUPT_NAME
+#	define ATMOS_UART_UDRE_INTERRUPT_NAME ATMOS_UART0_UDRE_INTERRUPT_NAME
+#elif ATMOS_UART_INDEX == 1
+#	ifndef ATMOS_UART1_DATA
+static_assert(false, "UART #1 is not available for selected device. Add your device UART configuration to uart_config.h");
+#	endif //ATMOS_UART1_DATA
+#	define ATMOS_UART_DATA ATMOS_UART1_DATA
+#	define ATMOS_UART_STATUS ATMOS_UART1_STATUS
+#	define ATMOS_UART_CONTROL ATMOS_UART1_CONTROL
+#	define ATMOS_UART_BAUD_HIGH ATMOS_UART1_BAUD_HIGH
+#	define ATMOS_UART_BAUD_LOW ATMOS_UART1_BAUD_LOW
+#	define ATMOS_UART_RX_INTERRUPT_NAME ATMOS_UART1_RX_INTERRUPT_NAME
+#	define ATMOS_UART_UDRE_INTERRUPT_NAME ATMOS_UART1_UDRE_INTERRUPT_NAME
+#elif ATMOS_UART_INDEX == 2
+#	ifndef ATMOS_UART2_DATA
+static_assert(false, "UART #2 is not available for selected device. Add your device UART configuration to uart_config.h");
+#	endif //ATMOS_UART2_DATA
+#	define ATMOS_UART_DATA ATMOS_UART2_DATA
+#	define ATMOS_UART_STATUS ATMOS_UART2_STATUS
+#	define ATMOS_UART_CONTROL ATMOS_UART2_CONTROL
+#	define ATMOS_UART_BAUD_HIGH ATMOS_UART2_BAUD_HIGH
+#	define ATMOS_UART_BAUD_LOW ATMOS_UART2_BAUD_LOW
+#	define ATMOS_UART_RX_INTERRUPT_NAME ATMOS_UART2_RX_INTERRUPT_NAME
+#	define ATMOS_UART_UDRE_INTERRUPT_NAME ATMOS_UART2_UDRE_INTERRUPT_NAME
+#elif ATMOS_UART_INDEX == 3
+#	ifndef ATMOS_UART3_DATA
+static_assert(false, "UART #3 is not available for selected device. Add your device UART configuration to uart_config.h");
+#	endif //ATMOS_UART3_DATA
+#	define ATMOS_UART_DATA ATMOS_UART3_DATA
+#	define ATMOS_UART_STATUS ATMOS_UART3_STATUS
+#	define ATMOS_UART_CONTROL ATMOS_UART3_CONTROL
+#	define ATMOS_UART_BAUD_HIGH ATMOS_UART3_BAUD_HIGH
+#	define ATMOS_UART_BAUD_LOW ATMOS_UART3_BAUD_LOW
+#	define ATMOS_UART_RX_INTERRUPT_NAME ATMOS_UART3_RX_INTERRUPT_NAME
+#	define ATMOS_UART_UDRE_INTERRUPT_NAME ATMOS_UART3_UDRE_INTERRUPT_NAME
+#else //ATMOS_UART_INDEX
+static_assert(false, "ATMOS_UART_INDEX has unsupported value. Supported values are 0 to 3.");
+#endif //ATMOS_UART_INDEX
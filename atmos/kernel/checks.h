@@ -24,6 +24,66 @@ static_assert(false, "You need to have F_CPU value defined");
 static_assert(false, "Interrupts must be enabled for ATMOS to work");
 #endif //__NO_INTERRUPTS__
 
+#if ATMOS_USE_INTERRUPT_STACK && __AVR_ARCH__ == 100
+static_assert(false, "ATMOS_USE_INTERRUPT_STACK is not supported for avrtiny architecture");
+#endif //ATMOS_USE_INTERRUPT_STACK && avrtiny
+
+#if ATMOS_SUPPORT_TICK_PERIOD_CHANGE && ATMOS_SINGLE_STACK_MODE
+static_assert(false, "ATMOS_SUPPORT_TICK_PERIOD_CHANGE is not supported in single-stack mode");
+#endif //ATMOS_SUPPORT_TICK_PERIOD_CHANGE && ATMOS_SINGLE_STACK_MODE
+
+#if ATMOS_SUPPORT_STATISTICS && (!ATMOS_SUPPORT_SLEEP || ATMOS_SINGLE_STACK_MODE)
+static_assert(false, "ATMOS_SUPPORT_STATISTICS requires ATMOS_SUPPORT_SLEEP and is not supported in single-stack mode");
+#endif //ATMOS_SUPPORT_STATISTICS && (!ATMOS_SUPPORT_SLEEP || ATMOS_SINGLE_STACK_MODE)
+
+#if ATMOS_SUPPORT_STATISTICS && (ATMOS_STATISTICS_HISTOGRAM_SIZE < 2 || ATMOS_STATISTICS_HISTOGRAM_SIZE > 16)
+static_assert(false, "ATMOS_STATISTICS_HISTOGRAM_SIZE must be 2 to 16");
+#endif //ATMOS_SUPPORT_STATISTICS && histogram size
+
+#if ATMOS_SUPPORT_IDLE_HOOK && (!ATMOS_ENABLE_SYSTEM_PROCESS || !ATMOS_SUPPORT_SLEEP || ATMOS_SINGLE_STACK_MODE)
+static_assert(false, "ATMOS_SUPPORT_IDLE_HOOK requires ATMOS_ENABLE_SYSTEM_PROCESS and ATMOS_SUPPORT_SLEEP"
+	" and is not supported in single-stack mode");
+#endif //ATMOS_SUPPORT_IDLE_HOOK && (!ATMOS_ENABLE_SYSTEM_PROCESS || !ATMOS_SUPPORT_SLEEP || ATMOS_SINGLE_STACK_MODE)
+
+#if ATMOS_SUPPORT_CPU_LOAD && (!ATMOS_ENABLE_SYSTEM_PROCESS || !ATMOS_SUPPORT_SLEEP || ATMOS_SINGLE_STACK_MODE)
+static_assert(false, "ATMOS_SUPPORT_CPU_LOAD requires ATMOS_ENABLE_SYSTEM_PROCESS and ATMOS_SUPPORT_SLEEP"
+	" and is not supported in single-stack mode");
+#endif //ATMOS_SUPPORT_CPU_LOAD && (!ATMOS_ENABLE_SYSTEM_PROCESS || !ATMOS_SUPPORT_SLEEP || ATMOS_SINGLE_STACK_MODE)
+
+#if ATMOS_SUPPORT_CPU_LOAD && (ATMOS_CPU_LOAD_WINDOW_TICKS < 1 || ATMOS_CPU_LOAD_WINDOW_TICKS > 255)
+static_assert(false, "ATMOS_CPU_LOAD_WINDOW_TICKS must be 1 to 255");
+#endif //ATMOS_SUPPORT_CPU_LOAD && window size
+
+#if ATMOS_SUPPORT_SUSPEND && (!ATMOS_SUPPORT_SLEEP || ATMOS_SINGLE_STACK_MODE)
+static_assert(false, "ATMOS_SUPPORT_SUSPEND requires ATMOS_SUPPORT_SLEEP and is not supported in single-stack mode");
+#endif //ATMOS_SUPPORT_SUSPEND && (!ATMOS_SUPPORT_SLEEP || ATMOS_SINGLE_STACK_MODE)
+
+#if ATMOS_SUPPORT_PRIORITIES && (!ATMOS_SUPPORT_SLEEP || ATMOS_SINGLE_STACK_MODE)
+static_assert(false, "ATMOS_SUPPORT_PRIORITIES requires ATMOS_SUPPORT_SLEEP and is not supported in single-stack mode");
+#endif //ATMOS_SUPPORT_PRIORITIES && (!ATMOS_SUPPORT_SLEEP || ATMOS_SINGLE_STACK_MODE)
+
+#if ATMOS_SUPPORT_PREEMPTION_THRESHOLD && !ATMOS_SUPPORT_PRIORITIES
+static_assert(false, "ATMOS_SUPPORT_PREEMPTION_THRESHOLD requires ATMOS_SUPPORT_PRIORITIES");
+#endif //ATMOS_SUPPORT_PREEMPTION_THRESHOLD && !ATMOS_SUPPORT_PRIORITIES
+
+#if ATMOS_SUPPORT_PROCESS_DESCRIPTORS && ATMOS_SINGLE_STACK_MODE
+static_assert(false, "ATMOS_SUPPORT_PROCESS_DESCRIPTORS is not supported in single-stack mode");
+#endif //ATMOS_SUPPORT_PROCESS_DESCRIPTORS && ATMOS_SINGLE_STACK_MODE
+
+#if !ATMOS_PREEMPTIVE && ATMOS_SINGLE_STACK_MODE
+static_assert(false, "Cooperative mode (ATMOS_PREEMPTIVE 0) is not supported in single-stack mode");
+#endif //!ATMOS_PREEMPTIVE && ATMOS_SINGLE_STACK_MODE
+
+#if !ATMOS_PREEMPTIVE && !ATMOS_SUPPORT_YIELD && !ATMOS_SUPPORT_SLEEP
+static_assert(false, "Cooperative mode (ATMOS_PREEMPTIVE 0) requires ATMOS_SUPPORT_YIELD or ATMOS_SUPPORT_SLEEP");
+#endif //!ATMOS_PREEMPTIVE && !ATMOS_SUPPORT_YIELD && !ATMOS_SUPPORT_SLEEP
+
+#if !ATMOS_PREEMPTIVE && (ATMOS_SUPPORT_TICK_PERIOD_CHANGE || ATMOS_SUPPORT_STATISTICS \
+	|| ATMOS_SUPPORT_CPU_LOAD || ATMOS_SUPPORT_PREEMPTION_THRESHOLD)
+static_assert(false, "ATMOS_SUPPORT_TICK_PERIOD_CHANGE, ATMOS_SUPPORT_STATISTICS, ATMOS_SUPPORT_CPU_LOAD"
+	" and ATMOS_SUPPORT_PREEMPTION_THRESHOLD are not supported in cooperative mode (ATMOS_PREEMPTIVE 0)");
+#endif //!ATMOS_PREEMPTIVE && preemptive features
+
 namespace detail
 {
 template<typename T>
@@ -0,0 +1,345 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "config.h"
+
+#if ATMOS_SUPPORT_SLEEP
+
+namespace atmos
+{
+
+#if ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+namespace detail
+{
+///<summary>Returns current scheduler tick period (see kernel::get_tick_period_us).</summary>
+///<returns>Tick period in microseconds.</returns>
+uint32_t get_tick_period_us();
+} //namespace detail
+#endif //ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+
+///Typed time durations and time points. Conversion of durations to scheduler ticks
+///is done with compile-time calculated multiply-shift factors instead of runtime division,
+///and is rounded up, so process never sleeps less than requested.
+namespace chrono
+{
+
+///Scheduler tick count type.
+using tick_t = ATMOS_TICK_COUNTER_TYPE;
+
+namespace detail
+{
+///Maximal value of unsigned integer type.
+template<typename T>
+struct max_value final
+{
+	static_assert(static_cast<T>(-1) > T{0}, "Duration representation type must be unsigned");
+	static constexpr T value = static_cast<T>(-1);
+};
+
+///Selects the smallest unsigned type (uint32_t or uint64_t) to do calculations in.
+template<bool Fits32Bits>
+struct calculation_type final
+{
+	using type = uint32_t;
+};
+
+template<>
+struct calculation_type<false> final
+{
+	using type = uint64_t;
+};
+
+///Unsigned type of the specified size.
+template<uint8_t Size>
+struct unsigned_type_of_size;
+
+template<>
+struct unsigned_type_of_size<1> final
+{
+	using type = uint8_t;
+};
+
+template<>
+struct unsigned_type_of_size<2> final
+{
+	using type = uint16_t;
+};
+
+template<>
+struct unsigned_type_of_size<4> final
+{
+	using type = uint32_t;
+};
+
+template<>
+struct unsigned_type_of_size<8> final
+{
+	using type = uint64_t;
+};
+
+///Unsigned duration representation type for integer type T of the same size. Used to keep
+///calculations in the smallest possible type, when duration is created from plain integer.
+template<typename T>
+using unsigned_rep = typename unsigned_type_of_size<sizeof(T)>::type;
+
+constexpr uint32_t gcd(uint32_t a, uint32_t b)
+{
+	return b ? gcd(b, a % b) : a;
+}
+
+///<summary>Finds the smallest shift for multiply-shift division, which gives exact results
+///         for all dividends up to max_dividend.</summary>
+///<param name="divisor">Divisor.</param>
+///<param name="max_dividend">Maximal dividend value.</param>
+///<returns>Shift value, or 64 if multiply-shift division does not fit 64-bit calculations.</returns>
+constexpr uint8_t find_division_shift(uint32_t divisor, uint64_t max_dividend)
+{
+	for(uint8_t shift = 0; shift != 64; ++shift)
+	{
+		uint64_t power = 1ull << shift;
+		uint64_t multiplier = (power + divisor - 1) / divisor;
+		uint64_t error = multiplier * divisor - power;
+		if(max_dividend > UINT64_MAX / multiplier)
+			return 64;
+
+		//floor(x * multiplier / 2^shift) == floor(x / divisor), if x * error < 2^shift.
+		if(!error || max_dividend <= (power - 1) / error)
+			return shift;
+	}
+
+	return 64;
+}
+
+///Converts durations of count type Rep with maximal value MaxCount from one period to another.
+///Result is rounded up.
+template<typename Rep, Rep MaxCount, uint32_t FromPeriodUs, uint32_t ToPeriodUs>
+struct period_converter final
+{
+	static constexpr uint32_t numerator = FromPeriodUs / gcd(FromPeriodUs, ToPeriodUs);
+	static constexpr uint32_t denominator = ToPeriodUs / gcd(FromPeriodUs, ToPeriodUs);
+
+	static_assert(MaxCount <= UINT64_MAX / numerator - denominator, "Duration is too long to convert");
+
+	///Maximal dividend value (count * numerator + denominator - 1).
+	static constexpr uint64_t max_dividend = MaxCount * static_cast<uint64_t>(numerator) + denominator - 1;
+
+	static constexpr uint8_t shift = find_division_shift(denominator, max_dividend);
+	static constexpr bool use_multiply_shift = shift != 64;
+	static constexpr uint64_t multiplier = use_multiply_shift ? ((1ull << shift) + denominator - 1) / denominator : 0;
+
+	///Maximal conversion result.
+	static constexpr uint64_t max_result = max_dividend / denominator;
+
+	using type = typename calculation_type<use_multiply_shift
+		? max_dividend <= UINT32_MAX / (multiplier ? multiplier : 1)
+		: max_dividend <= UINT32_MAX>::type;
+
+	using result_type = typename calculation_type<max_result <= UINT32_MAX>::type;
+
+	static constexpr result_type convert(Rep count)
+	{
+		return static_cast<result_type>(use_multiply_shift
+			? (static_cast<type>(count) * numerator + (denominator - 1)) * static_cast<type>(multiplier) >> shift
+			//Fallback to division, if multiply-shift does not fit 64 bits.
+			: (static_cast<type>(count) * numerator + (denominator - 1)) / denominator);
+	}
+};
+
+#if ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+///<summary>Converts duration count to scheduler ticks using current tick period. Result is rounded up
+///         and limited to maximal tick counter value, as tick period may be shorter than initial one.</summary>
+///<remarks>Calculations are done in 32 bits, if maximal duration in microseconds fits.</remarks>
+///<param name="count">Duration count.</param>
+///<returns>Number of scheduler ticks.</returns>
+template<typename Rep, uint32_t PeriodUs, Rep MaxCount>
+tick_t to_current_ticks(Rep count)
+{
+	using type = typename calculation_type<static_cast<uint64_t>(MaxCount) <= UINT32_MAX / PeriodUs>::type;
+	uint32_t tick_period_us = atmos::detail::get_tick_period_us();
+	type microseconds = static_cast<type>(count) * PeriodUs;
+	type result = microseconds / tick_period_us;
+	if(microseconds % tick_period_us)
+		++result;
+	
+	return result > max_value<tick_t>::value ? max_value<tick_t>::value : static_cast<tick_t>(result);
+}
+#endif //ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+} //namespace detail
+
+///Time duration.
+///<typeparam name="Rep">Unsigned type to store tick count.</typeparam>
+///<typeparam name="PeriodUs">Duration tick period in microseconds.</typeparam>
+///<typeparam name="MaxCount">Maximal count value this duration can have. Used to check
+///                           overflows at compile time. Defaults to maximal Rep value.</typeparam>
+template<typename Rep, uint32_t PeriodUs, Rep MaxCount = detail::max_value<Rep>::value>
+class duration final
+{
+	static_assert(PeriodUs > 0, "Duration period must be positive");
+
+public:
+	using rep = Rep;
+	static constexpr uint32_t period_us = PeriodUs;
+	static constexpr Rep max_count = MaxCount;
+
+public:
+	///<summary>Creates duration.</summary>
+	///<param name="count">Number of periods. Must not exceed MaxCount.</param>
+	constexpr explicit duration(Rep count)
+		: count_(count)
+	{
+	}
+
+	///<summary>Returns number of periods.</summary>
+	constexpr Rep count() const
+	{
+		return count_;
+	}
+
+private:
+	Rep count_;
+};
+
+template<typename Rep = uint16_t, Rep MaxCount = detail::max_value<Rep>::value>
+using microseconds = duration<Rep, 1ul, MaxCount>;
+
+template<typename Rep = uint16_t, Rep MaxCount = detail::max_value<Rep>::value>
+using milliseconds = duration<Rep, 1000ul, MaxCount>;
+
+template<typename Rep = uint8_t, Rep MaxCount = detail::max_value<Rep>::value>
+using seconds = duration<Rep, 1000000ul, MaxCount>;
+
+///Scheduler tick duration.
+using ticks = duration<tick_t, ATMOS_TICK_PERIOD_US>;
+
+///<summary>Converts duration to scheduler ticks. Result is rounded up.</summary>
+///<remarks>Fails to compile, if duration maximal count does not fit tick counter type.
+///If ATMOS_SUPPORT_TICK_PERIOD_CHANGE is enabled, overflow is checked against initial tick period,
+///and conversion is done at runtime using current tick period. Result is then limited to maximal
+///tick counter value, as it may not fit, when current tick period is shorter than initial one.</remarks>
+///<param name="value">Duration to convert.</param>
+///<returns>Number of scheduler ticks.</returns>
+template<typename Rep, uint32_t PeriodUs, Rep MaxCount>
+constexpr tick_t to_ticks(duration<Rep, PeriodUs, MaxCount> value)
+{
+	using converter = detail::period_converter<Rep, MaxCount, PeriodUs, ATMOS_TICK_PERIOD_US>;
+	static_assert(converter::max_result <= detail::max_value<tick_t>::value,
+		"Duration does not fit ATMOS_TICK_COUNTER_TYPE, use smaller MaxCount or larger tick counter type");
+#if ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+	return detail::to_current_ticks<Rep, PeriodUs, MaxCount>(value.count());
+#else //ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+	return static_cast<tick_t>(converter::convert(value.count()));
+#endif //ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+}
+
+///<summary>Converts duration to scheduler ticks. Result is rounded up and limited
+///         to maximal tick counter value.</summary>
+///<param name="value">Duration to convert.</param>
+///<returns>Number of scheduler ticks.</returns>
+template<typename Rep, uint32_t PeriodUs, Rep MaxCount>
+constexpr tick_t to_ticks_saturated(duration<Rep, PeriodUs, MaxCount> value)
+{
+#if ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+	return detail::to_current_ticks<Rep, PeriodUs, MaxCount>(value.count());
+#else //ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+	constexpr auto max_ticks = detail::max_value<tick_t>::value;
+	auto result = detail::period_converter<Rep, MaxCount, PeriodUs, ATMOS_TICK_PERIOD_US>::convert(value.count());
+	return result > max_ticks ? max_ticks : static_cast<tick_t>(result);
+#endif //ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+}
+
+///Point in time, measured in scheduler ticks since kernel start (see kernel::now).
+///Tick counter overflows, so time points can only be compared relative to current time.
+class time_point final
+{
+public:
+	///<summary>Creates time point.</summary>
+	///<param name="tick_count">Scheduler tick count.</param>
+	constexpr explicit time_point(tick_t tick_count)
+		: tick_count_(tick_count)
+	{
+	}
+
+	///<summary>Returns scheduler tick count.</summary>
+	constexpr tick_t tick_count() const
+	{
+		return tick_count_;
+	}
+
+	///<summary>Returns time point moved forward by duration.</summary>
+	template<typename Rep, uint32_t PeriodUs, Rep MaxCount>
+	constexpr time_point operator+(duration<Rep, PeriodUs, MaxCount> value) const
+	{
+		return time_point(static_cast<tick_t>(tick_count_ + to_ticks(value)));
+	}
+
+	///<summary>Returns number of ticks between two time points.</summary>
+	constexpr ticks operator-(time_point other) const
+	{
+		return ticks(static_cast<tick_t>(tick_count_ - other.tick_count_));
+	}
+
+	constexpr bool operator==(time_point other) const
+	{
+		return tick_count_ == other.tick_count_;
+	}
+
+	constexpr bool operator!=(time_point other) const
+	{
+		return tick_count_ != other.tick_count_;
+	}
+
+private:
+	tick_t tick_count_;
+};
+
+namespace detail
+{
+///<summary>Parses decimal literal digits at compile time.</summary>
+template<char... Digits>
+constexpr uint64_t parse_literal()
+{
+	const char digits[] = { Digits... };
+	uint64_t result = 0;
+	for(char digit : digits)
+	{
+		if(digit != '\'')
+			result = result * 10 + static_cast<uint64_t>(digit - '0');
+	}
+
+	return result;
+}
+
+///Duration type for literal with value Value: the smallest count type holding the value,
+///and maximal count equal to literal value, which allows exact overflow checks.
+template<uint64_t Value, uint32_t PeriodUs>
+using literal_duration = duration<typename calculation_type<Value <= UINT32_MAX>::type, PeriodUs,
+	static_cast<typename calculation_type<Value <= UINT32_MAX>::type>(Value)>;
+} //namespace detail
+
+///Duration literals, for example: process::sleep_for(100_ms);
+namespace literals
+{
+template<char... Digits>
+constexpr detail::literal_duration<detail::parse_literal<Digits...>(), 1ul> operator"" _us()
+{
+	return detail::literal_duration<detail::parse_literal<Digits...>(), 1ul>(detail::parse_literal<Digits...>());
+}
+
+template<char... Digits>
+constexpr detail::literal_duration<detail::parse_literal<Digits...>(), 1000ul> operator"" _ms()
+{
+	return detail::literal_duration<detail::parse_literal<Digits...>(), 1000ul>(detail::parse_literal<Digits...>());
+}
+
+template<char... Digits>
+constexpr detail::literal_duration<detail::parse_literal<Digits...>(), 1000000ul> operator"" _s()
+{
+	return detail::literal_duration<detail::parse_literal<Digits...>(), 1000000ul>(detail::parse_literal<Digits...>());
+}
+} //namespace literals
+
+} //namespace chrono
+} //namespace atmos
+
+#endif //ATMOS_SUPPORT_SLEEP
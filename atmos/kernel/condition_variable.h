@@ -0,0 +1,104 @@
+#pragma once
+
+#include "config.h"
+
+#if ATMOS_SUPPORT_SLEEP
+
+#include "deadline.h"
+#include "kernel_lock.h"
+#include "mutex.h"
+#include "noncopyable.h"
+#include "process.h"
+#include "wait_list.h"
+
+namespace atmos
+{
+
+///Condition variable, which is used together with mutex. Process atomically unlocks mutex and blocks
+///until condition variable is notified, so notification which is sent after mutex is unlocked is not lost.
+///Processes are woken up in FIFO order.
+class condition_variable : public nonmovable
+{
+public:
+	///<summary>Unlocks mutex and blocks current process until it is woken up by notify_one() or notify_all().
+	///         Mutex is locked again before return.</summary>
+	///<remarks>Process may be woken up when condition it waits for is not met (for example, other process
+	///has changed state before mutex is locked again), so condition must be checked in a loop.</remarks>
+	///<param name="locked_mutex">Mutex locked by current process.</param>
+	void wait(mutex& locked_mutex)
+	{
+		atmos::kernel_lock lock;
+		//Mutex is unlocked and process is blocked with interrupts disabled, so notification can not be lost.
+		locked_mutex.unlock();
+		waiters_.wait();
+		locked_mutex.lock();
+	}
+
+	///<summary>Unlocks mutex and blocks current process until it is woken up by notify_one() or notify_all(),
+	///         or until timeout expires. Mutex is locked again before return.</summary>
+	///<remarks>Mutex is locked again without timeout, so function may return later than timeout expires.</remarks>
+	///<param name="locked_mutex">Mutex locked by current process.</param>
+	///<param name="ticks">Timeout in scheduler ticks. If zero, mutex is just unlocked and locked again.</param>
+	///<returns>True if process was woken up by notification, false if timeout expired.</returns>
+	bool wait_for(mutex& locked_mutex, process::tick_t ticks)
+	{
+		atmos::kernel_lock lock;
+		locked_mutex.unlock();
+		bool notified = waiters_.wait_for(ticks);
+		locked_mutex.lock();
+		return notified;
+	}
+
+	///<summary>Blocks current process until predicate returns true. Mutex is unlocked while process is blocked.</summary>
+	///<remarks>Predicate is called with mutex locked.</remarks>
+	///<param name="locked_mutex">Mutex locked by current process.</param>
+	///<param name="ready">Predicate to check condition which process waits for.</param>
+	template<typename Predicate>
+	void wait(mutex& locked_mutex, Predicate&& ready)
+	{
+		while(!ready())
+			wait(locked_mutex);
+	}
+
+	///<summary>Blocks current process until predicate returns true or timeout expires.
+	///         Mutex is unlocked while process is blocked.</summary>
+	///<remarks>Predicate is called with mutex locked. Process may be woken up several times
+	///before condition is met, timeout is counted from the first call.</remarks>
+	///<param name="locked_mutex">Mutex locked by current process.</param>
+	///<param name="ticks">Timeout in scheduler ticks.</param>
+	///<param name="ready">Predicate to check condition which process waits for.</param>
+	///<returns>Last predicate result.</returns>
+	template<typename Predicate>
+	bool wait_for(mutex& locked_mutex, process::tick_t ticks, Predicate&& ready)
+	{
+		deadline time_limit(ticks);
+		while(!ready())
+		{
+			if(!wait_for(locked_mutex, time_limit.remaining()))
+				return ready();
+		}
+
+		return true;
+	}
+
+	///<summary>Wakes up first waiting process.</summary>
+	///<remarks>Can be called from ISR. Mutex does not need to be locked.</remarks>
+	void notify_one()
+	{
+		waiters_.notify_one();
+	}
+
+	///<summary>Wakes up all waiting processes.</summary>
+	///<remarks>Can be called from ISR. Mutex does not need to be locked.</remarks>
+	void notify_all()
+	{
+		waiters_.notify_all();
+	}
+
+private:
+	wait_list waiters_;
+};
+
+} //namespace atmos
+
+#endif //ATMOS_SUPPORT_SLEEP
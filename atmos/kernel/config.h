@@ -27,3 +27,141 @@
  *  Can be uint8_t, uint16_t, __uint24, uint32_t, uint64_t. Process will not be able to sleep for longer
  *  than (max value of ATMOS_TICK_COUNTER_TYPE) * ATMOS_TICK_PERIOD_US. */
 #define ATMOS_TICK_COUNTER_TYPE uint8_t
+
+/** If set to 1, canary word will be placed between process control block and process stack.
+ *  Canary value and saved process stack pointer are checked on every context switch, and
+ *  kernel::stack_overflow_hook is called if process stack overflow is detected.
+ *  Increases minimal process context size by 2 bytes. */
+#define ATMOS_STACK_OVERFLOW_CHECK 0
+
+/** If set to 1, scheduler and interrupt handlers declared with ATMOS_ISR (see interrupt.h) will run
+ *  on separate interrupt stack instead of the stack of interrupted process. Stack of main() function,
+ *  which is not used after kernel::run() call, is used as interrupt stack, so the memory between
+ *  static data and RAMEND must fit the deepest interrupt handler. Process stacks then need headroom only for
+ *  the process context and call-used registers saved on interrupt entry. Not supported for avrtiny devices. */
+#define ATMOS_USE_INTERRUPT_STACK 0
+
+/** If set to 1, kernel runs in single-stack mode. Processes are not available in this mode, run-to-completion
+ *  tasks with priorities are used instead (see task.h). All tasks share single hardware stack: higher priority task
+ *  preempts lower priority one by nesting on the stack, so task switch is a plain function call.
+ *  ATMOS_SUPPORT_SLEEP enables tick counter and delayed task activation in this mode. */
+#define ATMOS_SINGLE_STACK_MODE 0
+
+/** If set to 1, stackless coroutine tasks will be enabled (see coroutine.h). Coroutine tasks are run
+ *  by a scheduler inside a single host process and can await sleeps and events.
+ *  Requires C++20 coroutines support in compiler (-std=gnu++20) and ATMOS_SUPPORT_SLEEP. */
+#define ATMOS_SUPPORT_COROUTINES 0
+
+/** If set to 1, kernel::set_tick_period_us() will be enabled to change scheduler tick period at runtime
+ *  (for example, to use short ticks while device is active and long ticks to save power when it is idle).
+ *  ATMOS_TICK_PERIOD_US sets initial tick period. Not supported in single-stack mode. */
+#define ATMOS_SUPPORT_TICK_PERIOD_CHANGE 0
+
+/** If set to 1, interrupt-driven UART driver will be enabled (see drivers/uart.h). Processes that write to or read
+ *  from UART are blocked while transmit buffer is full or receive buffer is empty, and are woken up from UART interrupts.
+ *  Requires ATMOS_SUPPORT_SLEEP. */
+#define ATMOS_SUPPORT_UART 0
+
+/** Index of UART (USART) to use by UART driver (see drivers/uart_config.h). */
+#define ATMOS_UART_INDEX 0
+
+/** UART receive buffer size in bytes. Must be a power of two not greater than 128. */
+#define ATMOS_UART_RX_BUFFER_SIZE 32
+
+/** UART transmit buffer size in bytes. Must be a power of two not greater than 128. */
+#define ATMOS_UART_TX_BUFFER_SIZE 32
+
+/** If set to 1, interrupt-driven SPI master driver will be enabled (see drivers/spi.h).
+ *  Requires ATMOS_SUPPORT_SLEEP. */
+#define ATMOS_SUPPORT_SPI 0
+
+/** If set to 1, interrupt-driven TWI (I2C) master driver will be enabled (see drivers/twi.h).
+ *  Requires ATMOS_SUPPORT_SLEEP. */
+#define ATMOS_SUPPORT_TWI 0
+
+/** If set to 1, ADC sampling driver will be enabled (see drivers/adc.h). ADC conversions are auto triggered
+ *  by a timer, and samples are collected to double-buffered blocks, which are handed to consumer process.
+ *  Requires ATMOS_SUPPORT_SLEEP. */
+#define ATMOS_SUPPORT_ADC 0
+
+/** Number of samples in ADC sample block. Consumer process is woken up once per block. */
+#define ATMOS_ADC_BLOCK_SIZE 32
+
+/** ADC auto trigger source (ADTS bits value, see device datasheet), for example, 5 for Timer/Counter1 Compare Match B.
+ *  Trigger timer must be set up by user and determines sample rate. Free running mode (0) is not supported. */
+#define ATMOS_ADC_TRIGGER_SOURCE 5
+
+/** Register and bit of trigger event interrupt flag, which is cleared by ADC interrupt handler, so that the next
+ *  trigger event starts the next conversion. */
+#define ATMOS_ADC_TRIGGER_FLAG_REGISTER TIFR1
+#define ATMOS_ADC_TRIGGER_FLAG_BIT OCF1B
+
+/** If set to 1, kernel collects scheduler statistics (see kernel::stats): context switch counts by reason,
+ *  per-process run counts, scheduler interrupt durations and process wake up delays.
+ *  Requires ATMOS_SUPPORT_SLEEP. Adds 3 bytes to process control block. */
+#define ATMOS_SUPPORT_STATISTICS 0
+
+/** Number of buckets in each kernel statistics histogram (see kernel::stats). */
+#define ATMOS_STATISTICS_HISTOGRAM_SIZE 8
+
+/** Process stack space in bytes reserved in every process memory block (see process::minimal_context_size)
+ *  for scheduler, which runs on the stack of process it switches from. Scheduler has no stack frame,
+ *  but code added by ATMOS_SUPPORT_STATISTICS, ATMOS_SUPPORT_SUSPEND or ATMOS_SUPPORT_PRIORITIES may make it
+ *  save call-saved registers (up to 18 bytes) there. Scheduler also calls update_cpu_load with
+ *  ATMOS_SUPPORT_CPU_LOAD and advance_tick_count in cooperative mode (see ATMOS_PREEMPTIVE), which must fit too.
+ *  Not used, if all of them are disabled or if scheduler runs on interrupt stack (see ATMOS_USE_INTERRUPT_STACK). */
+#define ATMOS_SCHEDULER_STACK_SIZE 32
+
+/** If set to 1, system process calls kernel::idle_hook in a loop, when there are no other processes to run.
+ *  Requires ATMOS_ENABLE_SYSTEM_PROCESS and ATMOS_SUPPORT_SLEEP. */
+#define ATMOS_SUPPORT_IDLE_HOOK 0
+
+/** System process stack size in bytes, which must fit kernel::idle_hook call (see ATMOS_SUPPORT_IDLE_HOOK)
+ *  and process::yield call in cooperative mode (see ATMOS_PREEMPTIVE). Not used, if idle hook is disabled
+ *  in preemptive mode, as system process then does not use stack.
+ *  Scheduler stack space is reserved separately (see ATMOS_SCHEDULER_STACK_SIZE). */
+#define ATMOS_SYSTEM_PROCESS_STACK_SIZE 32
+
+/** If set to 1, kernel measures time spent in system process and calculates CPU load (see kernel::cpu_load).
+ *  Requires ATMOS_ENABLE_SYSTEM_PROCESS and ATMOS_SUPPORT_SLEEP. */
+#define ATMOS_SUPPORT_CPU_LOAD 0
+
+/** CPU load measurement window in scheduler ticks (1 to 255). CPU load is smoothed over several windows. */
+#define ATMOS_CPU_LOAD_WINDOW_TICKS 100
+
+/** If set to 1, process::suspend and process::resume methods will be enabled. Requires ATMOS_SUPPORT_SLEEP.
+ *  Adds 1 byte to process control block. */
+#define ATMOS_SUPPORT_SUSPEND 0
+
+/** If set to 1, processes will have priorities (see process::set_priority). Scheduler then runs processes
+ *  with the highest priority among running processes in round-robin order, and processes with lower priority
+ *  run only when all higher priority processes sleep or wait. New processes have the lowest priority 0.
+ *  Process which wakes up higher priority process (for example, gives semaphore) or changes priorities
+ *  switches to it right away in preemptive mode (see kernel_lock).
+ *  Requires ATMOS_SUPPORT_SLEEP. Adds 1 byte to process control block. */
+#define ATMOS_SUPPORT_PRIORITIES 0
+
+/** If set to 1, process lists and wait lists of kernel objects are doubly-linked, so that processes are removed
+ *  from them in O(1) time (when process goes to sleep, or is notified while waiting with timeout),
+ *  and are appended to wait lists in O(1) time.
+ *  Set to 0 to use singly-linked lists with O(n) removal, which saves 4 bytes of RAM per process. */
+#define ATMOS_DOUBLY_LINKED_PROCESS_LISTS 1
+
+/** If set to 1, processes can be created from constant descriptors placed to program memory
+ *  (see process_descriptor.h), which also keep process names for inspection without using RAM. */
+#define ATMOS_SUPPORT_PROCESS_DESCRIPTORS 0
+
+/** If set to 1, processes will have preemption thresholds (see process::set_preemption_threshold).
+ *  Running process can then be preempted by scheduler tick or ATMOS_ISR interrupt handler only by processes
+ *  with priority above its threshold, which reduces the number of context switches. Requires ATMOS_SUPPORT_PRIORITIES.
+ *  Adds 1 byte to process control block. */
+#define ATMOS_SUPPORT_PREEMPTION_THRESHOLD 0
+
+/** If set to 0, kernel is built in cooperative mode. Context is switched only when process yields, sleeps or waits,
+ *  and scheduler timer interrupt is not used. Process context then contains only call-saved registers
+ *  and SREG, which reduces minimal process context size and context switch time. Processes woken up by interrupt
+ *  handlers run when current process switches context. If ATMOS_SUPPORT_SLEEP is enabled, scheduler timer runs
+ *  freely, and tick count is advanced by reading timer counter on context switch and on kernel::get_tick_count call,
+ *  so processes must call into kernel before timer counter overflows. Use 16-bit timer to get longer period.
+ *  Not supported in single-stack mode. */
+#define ATMOS_PREEMPTIVE 1
@@ -208,3 +208,98 @@
 	"pop r31              \n\t" \
 	:: \
 )
+
+#if !ATMOS_PREEMPTIVE
+/** Save SREG on stack and disable interrupts. Can be called from OS process only (cooperative mode). */
+#	define save_sreg_from_task() __asm__ __volatile__ ( \
+		/* R31 is call-used, so it is not saved. */ \
+		"in r31, __SREG__ \n\t" \
+		"cli              \n\t" \
+		"push r31         \n\t" \
+		:: \
+	)
+
+/** Save call-saved registers on stack (cooperative mode). Compiler does not expect call-used registers
+ *  to be preserved across process::yield call, so they are not saved. */
+#	if __AVR_ARCH__ == ATMOS_AVRTINY_ARCH_ID //avrtiny, absent R0-R15 registers.
+#		define save_call_saved_context() __asm__ __volatile__ ( \
+			"push r18        \n\t" \
+			"push r19        \n\t" \
+			"push r28        \n\t" \
+			"push r29        \n\t" \
+			:: \
+		)
+#	else //not avrtiny
+#		define save_call_saved_context() __asm__ __volatile__ ( \
+			"push r2         \n\t" \
+			"push r3         \n\t" \
+			"push r4         \n\t" \
+			"push r5         \n\t" \
+			"push r6         \n\t" \
+			"push r7         \n\t" \
+			"push r8         \n\t" \
+			"push r9         \n\t" \
+			"push r10        \n\t" \
+			"push r11        \n\t" \
+			"push r12        \n\t" \
+			"push r13        \n\t" \
+			"push r14        \n\t" \
+			"push r15        \n\t" \
+			"push r16        \n\t" \
+			"push r17        \n\t" \
+			"push r28        \n\t" \
+			"push r29        \n\t" \
+			:: \
+		)
+#	endif //avrtiny
+
+/** Restore saved call-saved registers (cooperative mode). */
+#	if __AVR_ARCH__ == ATMOS_AVRTINY_ARCH_ID //avrtiny, absent R0-R15 registers.
+#		define restore_call_saved_context() __asm__ __volatile__ ( \
+			"pop r29              \n\t" \
+			"pop r28              \n\t" \
+			"pop r19              \n\t" \
+			"pop r18              \n\t" \
+			:: \
+		)
+#	else //not avrtiny
+#		define restore_call_saved_context() __asm__ __volatile__ ( \
+			"pop r29              \n\t" \
+			"pop r28              \n\t" \
+			"pop r17              \n\t" \
+			"pop r16              \n\t" \
+			"pop r15              \n\t" \
+			"pop r14              \n\t" \
+			"pop r13              \n\t" \
+			"pop r12              \n\t" \
+			"pop r11              \n\t" \
+			"pop r10              \n\t" \
+			"pop r9               \n\t" \
+			"pop r8               \n\t" \
+			"pop r7               \n\t" \
+			"pop r6               \n\t" \
+			"pop r5               \n\t" \
+			"pop r4               \n\t" \
+			"pop r3               \n\t" \
+			"pop r2               \n\t" \
+			:: \
+		)
+#	endif //avrtiny
+
+/** Restore SREG and return to the process (cooperative mode). */
+#	define restore_sreg_and_switch_context()  __asm__ __volatile__ ( \
+		"pop r31              \n\t" \
+		"sbrc r31, %0         \n\t" \
+		"rjmp 1f              \n\t" \
+		/* If bit I is cleared in saved SREG value, then just restore SREG and perform RET to the process. */ \
+		"out __SREG__, r31    \n\t" \
+		"ret                  \n\t" \
+		/* Otherwise, clear bit I, restore SREG and perform RETI to return to the process and */ \
+		/* enable interrupts at the same time. */ \
+		"1:                   \n\t" \
+		"andi r31, ~(1 << %0) \n\t" \
+		"out __SREG__, r31    \n\t" \
+		"reti                 \n\t" \
+		:: "I" (ATMOS_AVR_INTERRUPT_BIT) \
+	)
+#endif //!ATMOS_PREEMPTIVE
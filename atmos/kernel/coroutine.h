@@ -0,0 +1,578 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "config.h"
+
+#if ATMOS_SUPPORT_COROUTINES
+
+#include "defines.h"
+#include "forward_list.h"
+#include "kernel.h"
+#include "kernel_lock.h"
+#include "noncopyable.h"
+#include "process.h"
+#include "wait_list.h"
+
+#if !ATMOS_SUPPORT_SLEEP
+static_assert(false, "ATMOS_SUPPORT_COROUTINES requires ATMOS_SUPPORT_SLEEP");
+#endif //!ATMOS_SUPPORT_SLEEP
+
+#if ATMOS_SINGLE_STACK_MODE
+static_assert(false, "ATMOS_SUPPORT_COROUTINES can not be used in single-stack mode");
+#endif //ATMOS_SINGLE_STACK_MODE
+
+#ifndef __cpp_impl_coroutine
+static_assert(false, "ATMOS_SUPPORT_COROUTINES requires C++20 coroutines support (-std=gnu++20)");
+#endif //__cpp_impl_coroutine
+
+#if __has_include(<coroutine>)
+#	include <coroutine>
+#else //__has_include(<coroutine>)
+namespace std
+{
+///Minimal C++20 coroutine support library for toolchains without libstdc++ (avr-gcc).
+template<typename Result, typename... Args>
+struct coroutine_traits
+{
+	using promise_type = typename Result::promise_type;
+};
+
+template<typename Promise = void>
+struct coroutine_handle;
+
+template<>
+struct coroutine_handle<void>
+{
+	constexpr coroutine_handle() noexcept = default;
+
+	static coroutine_handle from_address(void* address) noexcept
+	{
+		coroutine_handle result;
+		result.frame_ = address;
+		return result;
+	}
+
+	void* address() const noexcept
+	{
+		return frame_;
+	}
+
+	explicit operator bool() const noexcept
+	{
+		return frame_ != nullptr;
+	}
+
+	bool done() const noexcept
+	{
+		return __builtin_coro_done(frame_);
+	}
+
+	void resume() const
+	{
+		__builtin_coro_resume(frame_);
+	}
+
+	void operator()() const
+	{
+		resume();
+	}
+
+	void destroy() const
+	{
+		__builtin_coro_destroy(frame_);
+	}
+
+protected:
+	void* frame_ = nullptr;
+};
+
+template<typename Promise>
+struct coroutine_handle : coroutine_handle<>
+{
+	static coroutine_handle from_address(void* address) noexcept
+	{
+		coroutine_handle result;
+		result.frame_ = address;
+		return result;
+	}
+
+	static coroutine_handle from_promise(Promise& promise) noexcept
+	{
+		coroutine_handle result;
+		result.frame_ = __builtin_coro_promise(&promise, __alignof(Promise), true);
+		return result;
+	}
+
+	Promise& promise() const
+	{
+		return *static_cast<Promise*>(__builtin_coro_promise(frame_, __alignof(Promise), false));
+	}
+};
+
+struct suspend_always
+{
+	constexpr bool await_ready() const noexcept { return false; }
+	constexpr void await_suspend(coroutine_handle<>) const noexcept {}
+	constexpr void await_resume() const noexcept {}
+};
+
+struct suspend_never
+{
+	constexpr bool await_ready() const noexcept { return true; }
+	constexpr void await_suspend(coroutine_handle<>) const noexcept {}
+	constexpr void await_resume() const noexcept {}
+};
+} //namespace std
+#endif //__has_include(<coroutine>)
+
+namespace atmos
+{
+namespace coroutine
+{
+
+class scheduler;
+
+///Base class for pre-allocated coroutine frame memory.
+class ATMOS_PACKED frame_memory : public nonmovable
+{
+public:
+	///<summary>Returns frame memory if it is large enough and is not used by another coroutine.</summary>
+	///<param name="size">Required coroutine frame size.</param>
+	///<returns>Pointer to frame memory or nullptr if memory block is too small or is in use.</returns>
+	void* allocate(size_t size)
+	{
+		if(in_use_ || size > size_)
+			return nullptr;
+
+		in_use_ = true;
+		return reinterpret_cast<uint8_t*>(this) + sizeof(frame_memory);
+	}
+
+	///<summary>Releases frame memory returned by allocate(), so that it can hold next coroutine frame.</summary>
+	///<param name="frame">Pointer to frame memory.</param>
+	static void release(void* frame)
+	{
+		reinterpret_cast<frame_memory*>(static_cast<uint8_t*>(frame) - sizeof(frame_memory))->in_use_ = false;
+	}
+
+protected:
+	explicit constexpr frame_memory(uint16_t size)
+		: size_(size)
+		, in_use_(false)
+	{
+	}
+
+private:
+	uint16_t size_;
+	///True while memory holds frame of live coroutine.
+	bool in_use_;
+};
+
+///Pre-allocated coroutine frame memory block. Can hold single coroutine frame at a time.
+///If frame does not fit or block still holds frame of another coroutine,
+///coroutine creation fails (see scheduler::spawn).
+template<size_t FrameSize>
+class ATMOS_PACKED frame_memory_block : public frame_memory
+{
+public:
+	static constexpr size_t memory_block_size = FrameSize;
+
+public:
+	///Creates frame memory block with required size.
+	///Fills memory with nullbytes.
+	constexpr frame_memory_block()
+		: frame_memory(FrameSize)
+		, memory_{}
+	{
+	}
+
+private:
+	uint8_t memory_[FrameSize];
+};
+
+class event;
+
+///Stackless coroutine task. Functions returning task must accept frame_memory
+///(or frame_memory_block) reference as their first argument, which is used to store coroutine frame.
+class task final : public noncopyable
+{
+public:
+	struct task_list_tag;
+	struct promise_type;
+	using task_list_element_tagged = container::forward_list_element_tagged<task_list_tag, promise_type>;
+
+	///Coroutine promise. Contains task wait state and list link.
+	struct promise_type : task_list_element_tagged
+	{
+		///Tick count when task started waiting.
+		process::tick_t wait_start = 0;
+		///Number of ticks to wait for.
+		process::tick_t wait_ticks = 0;
+		///Event the task waits for, or nullptr.
+		event* awaited_event = nullptr;
+		///Scheduler which runs the task (see scheduler::spawn).
+		scheduler* owner = nullptr;
+
+		template<typename... Args>
+		static void* operator new(size_t size, frame_memory& memory, Args&&...) noexcept
+		{
+			return memory.allocate(size);
+		}
+
+		static void operator delete(void* frame)
+		{
+			//Frame memory is owned by frame_memory_block, just mark it as free.
+			frame_memory::release(frame);
+		}
+
+		static task get_return_object_on_allocation_failure() noexcept
+		{
+			return task{};
+		}
+
+		task get_return_object() noexcept
+		{
+			return task{handle_type::from_promise(*this)};
+		}
+
+		std::suspend_always initial_suspend() const noexcept
+		{
+			return {};
+		}
+
+		std::suspend_always final_suspend() const noexcept
+		{
+			return {};
+		}
+
+		void return_void() const noexcept
+		{
+		}
+
+		void unhandled_exception() const noexcept
+		{
+		}
+
+		///<summary>Checks if task can be resumed.</summary>
+		///<param name="now">Current tick count.</param>
+		///<returns>True if task wait is over.</returns>
+		bool ready(process::tick_t now);
+
+		///<summary>Returns number of ticks left until task wait is over.</summary>
+		///<param name="now">Current tick count.</param>
+		///<param name="ticks">Receives number of ticks left. Not changed if task waits for event.</param>
+		///<returns>False if task waits for event without timeout.</returns>
+		bool remaining_ticks(process::tick_t now, process::tick_t& ticks) const;
+	};
+
+	using handle_type = std::coroutine_handle<promise_type>;
+
+public:
+	task() = default;
+
+	task(task&& other)
+		: handle_(other.handle_)
+	{
+		other.handle_ = {};
+	}
+
+	task& operator=(task&& other) = delete;
+
+	~task()
+	{
+		//Task was not spawned, so release the frame.
+		if(handle_)
+			handle_.destroy();
+	}
+
+	///Returns true if coroutine frame has been successfully allocated.
+	explicit operator bool() const
+	{
+		return static_cast<bool>(handle_);
+	}
+
+private:
+	explicit task(handle_type handle)
+		: handle_(handle)
+	{
+	}
+
+	friend class scheduler;
+
+private:
+	handle_type handle_;
+};
+
+///Auto-reset event which can be awaited by coroutine tasks.
+///Setting event resumes one waiting task. Can be set from ISR or other process.
+class event final : public nonmovable
+{
+public:
+	///<summary>Sets event and wakes up host process of the scheduler which runs waiting task.</summary>
+	///<remarks>Can be called from ISR.</remarks>
+	void set();
+
+	///Resets event.
+	void reset()
+	{
+		signaled_ = false;
+	}
+
+	///Awaiter for event.
+	struct awaiter
+	{
+		event& target;
+
+		bool await_ready() const noexcept
+		{
+			return target.try_consume();
+		}
+
+		bool await_suspend(task::handle_type handle) const noexcept
+		{
+			//Event can be set from ISR, so check it once more together with
+			//publishing the scheduler which set() has to wake up.
+			atmos::kernel_lock lock;
+			if(target.try_consume())
+				return false;
+
+			auto& promise = handle.promise();
+			promise.awaited_event = &target;
+			target.owner_ = promise.owner;
+			return true;
+		}
+
+		void await_resume() const noexcept
+		{
+		}
+	};
+
+	awaiter operator co_await()
+	{
+		return awaiter{*this};
+	}
+
+private:
+	///Resets event, if it is set.
+	///<returns>True if event was set.</returns>
+	bool try_consume()
+	{
+		if(!signaled_)
+			return false;
+
+		signaled_ = false;
+		return true;
+	}
+
+	friend struct task::promise_type;
+
+private:
+	volatile bool signaled_ = false;
+	///Scheduler of the last task which awaited the event, or nullptr.
+	scheduler* owner_ = nullptr;
+};
+
+///Awaiter to suspend task for specified amount of scheduler ticks.
+struct sleep_awaiter
+{
+	process::tick_t ticks;
+
+	bool await_ready() const noexcept
+	{
+		return false;
+	}
+
+	void await_suspend(task::handle_type handle) const
+	{
+		auto& promise = handle.promise();
+		promise.wait_start = kernel::get_tick_count();
+		promise.wait_ticks = ticks;
+	}
+
+	void await_resume() const noexcept
+	{
+	}
+};
+
+///<summary>Suspends execution of current task for specified amount of scheduler ticks.</summary>
+///<param name="ticks">Number of ticks to sleep for. Zero just yields to other tasks.</param>
+inline sleep_awaiter sleep_ticks(process::tick_t ticks)
+{
+	return sleep_awaiter{ticks};
+}
+
+///<summary>Suspends execution of current task for specified amount of milliseconds.</summary>
+///<param name="milliseconds">Number of milliseconds to sleep for.</param>
+template<typename T>
+sleep_awaiter sleep_ms(T milliseconds)
+{
+	using rep = chrono::detail::unsigned_rep<T>;
+	return sleep_ticks(chrono::to_ticks_saturated(chrono::milliseconds<rep>(static_cast<rep>(milliseconds))));
+}
+
+///<summary>Yields execution from current task to other tasks of the same scheduler.</summary>
+inline sleep_awaiter yield()
+{
+	return sleep_ticks(0);
+}
+
+inline bool task::promise_type::ready(process::tick_t now)
+{
+	if(awaited_event)
+	{
+		if(!awaited_event->try_consume())
+			return false;
+
+		awaited_event = nullptr;
+		return true;
+	}
+
+	return static_cast<process::tick_t>(now - wait_start) >= wait_ticks;
+}
+
+inline bool task::promise_type::remaining_ticks(process::tick_t now, process::tick_t& ticks) const
+{
+	if(awaited_event)
+		return false;
+
+	auto elapsed = static_cast<process::tick_t>(now - wait_start);
+	ticks = elapsed >= wait_ticks ? 0 : static_cast<process::tick_t>(wait_ticks - elapsed);
+	return true;
+}
+
+///Runs coroutine tasks inside single host process.
+class scheduler final : public nonmovable
+{
+public:
+	///<summary>Adds task to the scheduler. Task will be run during next scheduler pass.</summary>
+	///<param name="new_task">Task to run.</param>
+	///<returns>False if task frame was not allocated (frame_memory_block is too small or is in use).</returns>
+	bool spawn(task&& new_task)
+	{
+		if(!new_task)
+			return false;
+
+		auto& promise = new_task.handle_.promise();
+		promise.owner = this;
+		tasks_.push_front(&promise);
+		new_task.handle_ = {};
+		return true;
+	}
+
+	///<summary>Resumes all tasks which are ready to run. Destroys completed tasks.</summary>
+	///<returns>True if at least one task was resumed.</returns>
+	bool run_once()
+	{
+		bool resumed = false;
+		auto now = kernel::get_tick_count();
+		auto* current = tasks_.first();
+		while(current)
+		{
+			auto* next = task_list::next(current);
+			auto& promise = static_cast<task::promise_type&>(*current);
+			if(promise.ready(now))
+			{
+				auto handle = task::handle_type::from_promise(promise);
+				handle.resume();
+				resumed = true;
+				if(handle.done())
+				{
+					tasks_.remove(current);
+					handle.destroy();
+				}
+			}
+
+			current = next;
+		}
+
+		return resumed;
+	}
+
+	///<summary>Runs tasks forever. Must be called from host process.
+	///         When no task is ready, host process is blocked until some awaited event is set
+	///         or the nearest task sleep is over.</summary>
+	///<remarks>If all tasks wait for events without timeout, host process is blocked
+	///without timeout, so you may also need to enable system process (see ATMOS_ENABLE_SYSTEM_PROCESS).</remarks>
+	void ATMOS_NORETURN run()
+	{
+		while(true)
+		{
+			notified_ = false;
+			run_once();
+
+			process::tick_t timeout;
+			bool has_timeout = nearest_timeout(timeout);
+			atmos::kernel_lock lock;
+			//Event could have been set while tasks were running.
+			if(notified_)
+				continue;
+
+			if(has_timeout)
+				host_.wait_for(timeout);
+			else
+				host_.wait();
+		}
+	}
+
+	///Returns true if scheduler has no tasks.
+	bool empty() const
+	{
+		return tasks_.empty();
+	}
+
+private:
+	///<summary>Wakes up host process blocked in run().</summary>
+	///<remarks>Can be called from ISR.</remarks>
+	void notify()
+	{
+		atmos::kernel_lock lock;
+		notified_ = true;
+		host_.notify_one();
+	}
+
+	///<summary>Finds number of ticks until the nearest task sleep is over.</summary>
+	///<param name="timeout">Receives number of ticks.</param>
+	///<returns>False if there are no sleeping tasks.</returns>
+	bool nearest_timeout(process::tick_t& timeout)
+	{
+		bool found = false;
+		auto now = kernel::get_tick_count();
+		for(auto* current = tasks_.first(); current; current = task_list::next(current))
+		{
+			process::tick_t ticks;
+			if(!static_cast<task::promise_type&>(*current).remaining_ticks(now, ticks))
+				continue;
+
+			if(!found || ticks < timeout)
+				timeout = ticks;
+			found = true;
+		}
+
+		return found;
+	}
+
+	friend class event;
+
+private:
+	using task_list = container::forward_list_tagged<task::task_list_element_tagged>;
+	task_list tasks_;
+	///Host process blocked in run() while no task is ready.
+	wait_list host_;
+	///Set by notify() to prevent host process from blocking after tasks were checked.
+	volatile bool notified_ = false;
+};
+
+inline void event::set()
+{
+	atmos::kernel_lock lock;
+	signaled_ = true;
+	if(owner_)
+		owner_->notify();
+}
+
+} //namespace coroutine
+} //namespace atmos
+
+#endif //ATMOS_SUPPORT_COROUTINES
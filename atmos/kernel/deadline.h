@@ -0,0 +1,41 @@
+#pragma once
+
+#include "config.h"
+
+#if ATMOS_SUPPORT_SLEEP
+
+#include "kernel.h"
+#include "process.h"
+
+namespace atmos
+{
+
+///Timeout of blocking operation, which may consist of several waits (see wait_list::wait_for).
+///Timeout is counted from deadline creation.
+class deadline final
+{
+public:
+	///<summary>Creates deadline.</summary>
+	///<param name="ticks">Timeout in scheduler ticks.</param>
+	explicit deadline(process::tick_t ticks)
+		: start_(kernel::get_tick_count())
+		, ticks_(ticks)
+	{
+	}
+
+	///<summary>Returns number of ticks left until deadline.</summary>
+	///<returns>Number of ticks left, or zero if deadline has passed.</returns>
+	process::tick_t remaining() const
+	{
+		auto elapsed = static_cast<process::tick_t>(kernel::get_tick_count() - start_);
+		return elapsed >= ticks_ ? 0 : static_cast<process::tick_t>(ticks_ - elapsed);
+	}
+
+private:
+	process::tick_t start_;
+	process::tick_t ticks_;
+};
+
+} //namespace atmos
+
+#endif //ATMOS_SUPPORT_SLEEP
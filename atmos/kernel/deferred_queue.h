@@ -0,0 +1,130 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "config.h"
+
+#if ATMOS_SUPPORT_SLEEP
+
+#include "defines.h"
+#include "kernel_lock.h"
+#include "noncopyable.h"
+#include "wait_list.h"
+
+namespace atmos
+{
+
+///Queue of deferred function calls (bottom halves). ISRs post short calls to the queue,
+///and a dedicated worker process executes them with interrupts enabled.
+///Worker process entry point should just call run(), for example:
+///<code>void worker() { queue.run(); }</code>
+///<typeparam name="Capacity">Maximum number of queued calls. Must be a power of two not greater than 128.</typeparam>
+template<uint8_t Capacity>
+class deferred_queue : public nonmovable
+{
+	static_assert(Capacity && Capacity <= 128 && !(Capacity & (Capacity - 1)),
+		"Capacity must be a power of two not greater than 128");
+
+public:
+	///Deferred function type.
+	using function_type = void(*)(uint16_t argument);
+
+public:
+	///<summary>Posts function call to the queue and wakes up worker process.</summary>
+	///<remarks>Can be called from ISR.</remarks>
+	///<param name="function">Function to call. Can not be nullptr.</param>
+	///<param name="argument">Argument to pass to function.</param>
+	///<returns>False if queue is full.</returns>
+	bool post(function_type function, uint16_t argument = 0);
+
+	///<summary>Executes queued calls. Blocks worker process while the queue is empty. Does not return.</summary>
+	void ATMOS_NORETURN run();
+
+	///<summary>Executes all calls which are currently queued.</summary>
+	///<returns>Number of executed calls.</returns>
+	uint8_t run_pending();
+
+private:
+	///Deferred call.
+	struct ATMOS_PACKED call
+	{
+		function_type function;
+		uint16_t argument;
+	};
+
+	///<summary>Pops next call from the queue.</summary>
+	///<remarks>Expects that interrupts are disabled and queue is not empty.</remarks>
+	call pop();
+
+private:
+	call calls_[Capacity];
+	///Index of first queued call (wraps around).
+	uint8_t head_ = 0;
+	///Index after last queued call (wraps around).
+	uint8_t tail_ = 0;
+	wait_list worker_;
+};
+
+template<uint8_t Capacity>
+bool deferred_queue<Capacity>::post(function_type function, uint16_t argument)
+{
+	atmos::kernel_lock lock;
+	if(static_cast<uint8_t>(tail_ - head_) == Capacity)
+		return false;
+
+	auto& target = calls_[tail_ & (Capacity - 1)];
+	target.function = function;
+	target.argument = argument;
+	++tail_;
+
+	worker_.notify_one();
+	return true;
+}
+
+template<uint8_t Capacity>
+typename deferred_queue<Capacity>::call deferred_queue<Capacity>::pop()
+{
+	return calls_[head_++ & (Capacity - 1)];
+}
+
+template<uint8_t Capacity>
+void deferred_queue<Capacity>::run()
+{
+	while(true)
+	{
+		call next;
+		{
+			atmos::kernel_lock lock;
+			while(head_ == tail_)
+				worker_.wait();
+
+			next = pop();
+		}
+
+		next.function(next.argument);
+	}
+}
+
+template<uint8_t Capacity>
+uint8_t deferred_queue<Capacity>::run_pending()
+{
+	uint8_t count = 0;
+	while(true)
+	{
+		call next;
+		{
+			atmos::kernel_lock lock;
+			if(head_ == tail_)
+				return count;
+
+			next = pop();
+		}
+
+		next.function(next.argument);
+		++count;
+	}
+}
+
+} //namespace atmos
+
+#endif //ATMOS_SUPPORT_SLEEP
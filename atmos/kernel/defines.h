@@ -30,6 +30,9 @@
 ///Not inlined functions.
 #define ATMOS_NOINLINE __attribute__((noinline))
 
+///Weak symbols, which can be redefined by user.
+#define ATMOS_WEAK __attribute__((weak))
+
 ///Always inlined functions.
 #define ATMOS_ALWAYS_INLINE __attribute__((always_inline)) inline
 
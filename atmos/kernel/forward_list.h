@@ -41,6 +41,22 @@ struct ATMOS_PACKED forward_list_base
 	///<param name="elem">Element not attached to any list. Can not be nullptr.</param>
 	void insert_before(forward_list_element* prev, forward_list_element* current, forward_list_element* elem) ATMOS_NONNULL(2, 3);
 	
+	///<summary>Insert element "elem" after element "pos".</summary>
+	///<param name="pos">Element of this list. Can not be nullptr.</param>
+	///<param name="elem">Element not attached to any list. Can not be nullptr.</param>
+	void insert_after(forward_list_element* pos, forward_list_element* elem) ATMOS_NONNULL(1, 2);
+	
+	///<summary>Move front elements of another list to front of this list.</summary>
+	///<param name="other">List to move elements from.</param>
+	///<param name="last">Last element of "other" list to move. All elements before it are moved too. Can not be nullptr.</param>
+	void splice_front(forward_list_base& other, forward_list_element* last) ATMOS_NONNULL(2);
+	
+	///<summary>Returns true if element is contained in list.</summary>
+	///<remarks>Has O(n) time complexity.</remarks>
+	///<param name="elem">Any element of any list.</param>
+	///<returns>True if element is contained in list.</returns>
+	bool contains(const forward_list_element* elem) const;
+	
 	///<summary>Returns true if list is empty.</summary>
 	///<returns>True if list is empty, false otherwise.</returns>
 	bool empty() const;
@@ -97,6 +113,31 @@ inline void forward_list_base::insert_before(forward_list_element* prev,
 		first_element = elem;
 }
 
+inline void forward_list_base::insert_after(forward_list_element* pos, forward_list_element* elem)
+{
+	elem->next = pos->next;
+	pos->next = elem;
+}
+
+inline void forward_list_base::splice_front(forward_list_base& other, forward_list_element* last)
+{
+	auto* first = other.first_element;
+	other.first_element = last->next;
+	last->next = first_element;
+	first_element = first;
+}
+
+inline bool forward_list_base::contains(const forward_list_element* elem) const
+{
+	for(auto* current = first_element; current; current = current->next)
+	{
+		if(current == elem)
+			return true;
+	}
+	
+	return false;
+}
+
 inline bool forward_list_base::empty() const
 {
 	return !first_element;
@@ -133,11 +174,17 @@ struct ATMOS_PACKED forward_list_tagged : private forward_list_base
 	using contained_type = typename list_element_type::contained_type;
 
 	using forward_list_base::empty;
+	using forward_list_base::contains;
 
 	///<summary>Push new element to front of list.</summary>
 	///<param name="elem">Element not attached to any list of the same type. Can not be nullptr.</param>
 	void push_front(list_element_type* elem) ATMOS_NONNULL(1);
 
+	///<summary>Push new element to back of list.</summary>
+	///<remarks>Has O(n) time complexity.</remarks>
+	///<param name="elem">Element not attached to any list of the same type. Can not be nullptr.</param>
+	void push_back(list_element_type* elem) ATMOS_NONNULL(1);
+
 	///<summary>Pop front element of list.</summary>
 	///<returns>Front list element or nullptr if list is empty.</returns>
 	list_element_type* pop_front();
@@ -160,6 +207,16 @@ struct ATMOS_PACKED forward_list_tagged : private forward_list_base
 	template<typename Func>
 	void insert_before(list_element_type* elem, Func&& compare) ATMOS_NONNULL(1);
 	
+	///<summary>Insert element "elem" after element "pos".</summary>
+	///<param name="pos">Element of this list. Can not be nullptr.</param>
+	///<param name="elem">Element not attached to any list of the same type. Can not be nullptr.</param>
+	void insert_after(list_element_type* pos, list_element_type* elem) ATMOS_NONNULL(1, 2);
+	
+	///<summary>Move front elements of another list to front of this list.</summary>
+	///<param name="other">List to move elements from.</param>
+	///<param name="last">Last element of "other" list to move. All elements before it are moved too. Can not be nullptr.</param>
+	void splice_front(forward_list_tagged& other, list_element_type* last) ATMOS_NONNULL(2);
+	
 	///<summary>Returns element after "elem" element.</summary>
 	///<param name="elem">Any element of any list. Can not be nullptr.</param>
 	///<returns>Element after "elem" element or nullptr if there is no element.</returns>
@@ -181,6 +238,15 @@ void forward_list_tagged<ForwardListElement>::push_front(list_element_type* elem
 	forward_list_base::push_front(elem);
 }
 
+template<typename ForwardListElement>
+void forward_list_tagged<ForwardListElement>::push_back(list_element_type* elem)
+{
+	insert_before(elem, [](const contained_type*)
+	{
+		return false;
+	});
+}
+
 template<typename ForwardListElement>
 typename forward_list_tagged<ForwardListElement>::list_element_type*
 	forward_list_tagged<ForwardListElement>::pop_front()
@@ -219,6 +285,18 @@ void forward_list_tagged<ForwardListElement>::insert_before(list_element_type* e
 	return forward_list_base::insert_before(prev, current, elem);
 }
 
+template<typename ForwardListElement>
+void forward_list_tagged<ForwardListElement>::insert_after(list_element_type* pos, list_element_type* elem)
+{
+	forward_list_base::insert_after(pos, elem);
+}
+
+template<typename ForwardListElement>
+void forward_list_tagged<ForwardListElement>::splice_front(forward_list_tagged& other, list_element_type* last)
+{
+	forward_list_base::splice_front(other, last);
+}
+
 template<typename ForwardListElement>
 typename forward_list_tagged<ForwardListElement>::list_element_type*
 	forward_list_tagged<ForwardListElement>::next(list_element_type* elem)
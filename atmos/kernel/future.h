@@ -0,0 +1,166 @@
+#pragma once
+
+#include "config.h"
+
+#if ATMOS_SUPPORT_SLEEP
+
+#include "kernel_lock.h"
+#include "noncopyable.h"
+#include "process.h"
+#include "wait_list.h"
+
+namespace atmos
+{
+
+template<typename T>
+class promise;
+
+///Future, which is used to wait for the result set by promise. Future only references promise,
+///so it can be copied and passed to several processes, which all are woken up when the result is set.
+///Promise must outlive all its futures.
+///<typeparam name="T">Result type. Must be copyable.</typeparam>
+template<typename T>
+class future
+{
+public:
+	///<summary>Creates future, which is not associated with promise.</summary>
+	constexpr future() = default;
+
+	///<summary>Returns true if future is associated with promise (see promise::get_future).</summary>
+	///<returns>True if future is valid.</returns>
+	bool valid() const
+	{
+		return state_ != nullptr;
+	}
+
+	///<summary>Returns true if result is set.</summary>
+	///<remarks>Future must be valid.</remarks>
+	///<returns>True if result is set.</returns>
+	bool ready() const;
+
+	///<summary>Blocks current process until result is set.</summary>
+	///<remarks>Future must be valid.</remarks>
+	void wait() const;
+
+	///<summary>Blocks current process until result is set, but not longer than timeout.</summary>
+	///<remarks>Future must be valid.</remarks>
+	///<param name="ticks">Timeout in scheduler ticks. If zero, function does not block.</param>
+	///<returns>True if result is set, false if timeout expired.</returns>
+	bool wait_for(process::tick_t ticks) const;
+
+	///<summary>Blocks current process until result is set and returns result.</summary>
+	///<remarks>Future must be valid. Result stays available until promise is reset,
+	///so it can be read several times.</remarks>
+	///<returns>Copy of result.</returns>
+	T get() const;
+
+	///<summary>Blocks current process until result is set, but not longer than timeout, and reads result.</summary>
+	///<remarks>Future must be valid.</remarks>
+	///<param name="value">Variable to copy result to. Not changed if timeout expires.</param>
+	///<param name="ticks">Timeout in scheduler ticks. If zero, function does not block.</param>
+	///<returns>True if result was read, false if timeout expired.</returns>
+	bool get_for(T& value, process::tick_t ticks) const;
+
+private:
+	friend class promise<T>;
+
+	explicit future(promise<T>* state)
+		: state_(state)
+	{
+	}
+
+private:
+	promise<T>* state_ = nullptr;
+};
+
+///Promise, which stores one-shot result of some operation (for example, ADC conversion or remote request)
+///and wakes up processes waiting for it with future. Result is stored inside promise, no dynamic memory is used.
+///Result can be set from ATMOS_ISR interrupt handler, then waiting process is run right on handler exit
+///(see interrupt.h).
+///<typeparam name="T">Result type. Must be default constructible and copyable.</typeparam>
+template<typename T>
+class promise : public nonmovable
+{
+public:
+	///<summary>Returns future associated with this promise.</summary>
+	///<returns>Future.</returns>
+	future<T> get_future()
+	{
+		return future<T>(this);
+	}
+
+	///<summary>Sets result and wakes up all processes waiting for it.</summary>
+	///<remarks>Can be called from ISR. Result is copied with interrupts disabled.</remarks>
+	///<param name="value">Result.</param>
+	///<returns>True if result was set, false if result was already set before.</returns>
+	bool set_value(const T& value)
+	{
+		atmos::kernel_lock lock;
+		if(ready_)
+			return false;
+
+		value_ = value;
+		ready_ = true;
+		waiters_.notify_all();
+		return true;
+	}
+
+	///<summary>Clears result, so that promise can be used for the next operation.</summary>
+	///<remarks>Can be called from ISR. Existing futures stay associated with promise.</remarks>
+	void reset()
+	{
+		atmos::kernel_lock lock;
+		ready_ = false;
+	}
+
+private:
+	friend class future<T>;
+
+	T value_{};
+	bool ready_ = false;
+	wait_list waiters_;
+};
+
+template<typename T>
+bool future<T>::ready() const
+{
+	atmos::kernel_lock lock;
+	return state_->ready_;
+}
+
+template<typename T>
+void future<T>::wait() const
+{
+	atmos::kernel_lock lock;
+	state_->waiters_.wait([this] { return state_->ready_; });
+}
+
+template<typename T>
+bool future<T>::wait_for(process::tick_t ticks) const
+{
+	atmos::kernel_lock lock;
+	return state_->waiters_.wait_for(ticks, [this] { return state_->ready_; });
+}
+
+template<typename T>
+T future<T>::get() const
+{
+	atmos::kernel_lock lock;
+	state_->waiters_.wait([this] { return state_->ready_; });
+	return state_->value_;
+}
+
+template<typename T>
+bool future<T>::get_for(T& value, process::tick_t ticks) const
+{
+	atmos::kernel_lock lock;
+	if(!state_->waiters_.wait_for(ticks, [this] { return state_->ready_; }))
+		return false;
+
+	value = state_->value_;
+	return true;
+}
+
+} //namespace atmos
+
+#endif //ATMOS_SUPPORT_SLEEP
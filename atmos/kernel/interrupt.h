@@ -0,0 +1,43 @@
+#pragma once
+
+#include <avr/interrupt.h>
+
+#include "config.h"
+#include "defines.h"
+
+/** \file Kernel-aware interrupt handlers definition.
+ *  Use ATMOS_ISR instead of ISR to define interrupt handler, which runs on the interrupt stack
+ *  if ATMOS_USE_INTERRUPT_STACK is enabled. Only call-used registers and SREG are saved on the stack of the
+ *  interrupted process. Handlers must not enable interrupts.
+ *  If handler wakes up a process (for example, gives a semaphore), context is switched to the woken up process
+ *  right on handler exit, without waiting for the next scheduler tick (requires ATMOS_SUPPORT_SLEEP,
+ *  is not done in cooperative mode, see ATMOS_PREEMPTIVE).
+ *  Usage: ATMOS_ISR(TIMER0_COMPA_vect) { ...handler code... } */
+
+/** Set to 1 if ATMOS_ISR handlers are called through common kernel interrupt entry
+ *  (atmos_interrupt_entry), which switches stacks and reschedules processes on handler exit. */
+#if !ATMOS_SINGLE_STACK_MODE && (ATMOS_USE_INTERRUPT_STACK \
+	|| (ATMOS_SUPPORT_SLEEP && ATMOS_PREEMPTIVE && __AVR_ARCH__ != 100))
+#	define ATMOS_KERNEL_AWARE_ISR 1
+#else //kernel-aware ISR
+#	define ATMOS_KERNEL_AWARE_ISR 0
+#endif //kernel-aware ISR
+
+#if ATMOS_KERNEL_AWARE_ISR
+#	define ATMOS_ISR(vector) \
+	static void vector##_atmos_handler(); \
+	ISR(vector, ISR_NAKED) \
+	{ \
+		__asm__ __volatile__ ( \
+			"push r30                    \n\t" \
+			"push r31                    \n\t" \
+			"ldi r30, lo8(gs(%x0))       \n\t" \
+			"ldi r31, hi8(gs(%x0))       \n\t" \
+			ATMOS_JUMP "atmos_interrupt_entry \n\t" \
+			:: "i" (vector##_atmos_handler) \
+		); \
+	} \
+	static void vector##_atmos_handler()
+#else //ATMOS_KERNEL_AWARE_ISR
+#	define ATMOS_ISR(vector) ISR(vector)
+#endif //ATMOS_KERNEL_AWARE_ISR
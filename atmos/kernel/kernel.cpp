@@ -1,3 +1,7 @@
+#include "config.h"
+
+#if !ATMOS_SINGLE_STACK_MODE
+
 #include "kernel.h"
 
 #pragma GCC diagnostic push
@@ -6,18 +10,28 @@
 #include <avr/interrupt.h>
 #include <avr/io.h>
 
-#include "config.h"
 #include "context_switch.h"
 #include "defines.h"
 #include "forward_list.h"
+#include "interrupt.h"
 #include "kernel_lock.h"
 #include "process.h"
+#include "process_descriptor.h"
 #include "process_memory.h"
 #include "scheduler_timer_setup.h"
 #include "utils.h"
+#include "wait_list.h"
 
 #pragma GCC diagnostic pop
 
+#if ATMOS_SUPPORT_SLEEP && ATMOS_PREEMPTIVE
+///Set to 1 if scheduler is passed a flag, which is non-zero when scheduler is called by scheduler tick.
+///In cooperative mode scheduler advances tick count itself (see advance_tick_count).
+#	define ATMOS_SCHEDULER_TICK_FLAG 1
+#else //ATMOS_SUPPORT_SLEEP && ATMOS_PREEMPTIVE
+#	define ATMOS_SCHEDULER_TICK_FLAG 0
+#endif //ATMOS_SUPPORT_SLEEP && ATMOS_PREEMPTIVE
+
 namespace
 {
 
@@ -25,7 +39,7 @@ using process_list_element = atmos::process::process_list_element;
 using process_list_element_tagged = atmos::process::process_list_element_tagged;
 
 ///List of running processes.
-using process_list = atmos::container::forward_list_tagged<process_list_element_tagged>;
+using process_list = atmos::process::process_list;
 
 ///Currently running process.
 process_list_element_tagged* current_process = nullptr;
@@ -42,9 +56,170 @@ process_list_element_tagged* next_process = nullptr;
 process_list waiting_processes{};
 process_list waiting_processes_overflown{};
 atmos::process::tick_t tick_counter = 0;
+///Set when process is woken up. Context switch is then performed on ATMOS_ISR interrupt handler exit
+///(see interrupt.h). Cleared on each context switch and on ATMOS_ISR handler entry, so that wake-ups
+///in process context do not force context switch on exit of unrelated handler.
+volatile bool reschedule_requested asm("atmos_reschedule_requested") ATMOS_USED = false;
+#	if !ATMOS_PREEMPTIVE
+///Free-running scheduler timer counter value, when current tick started.
+uint16_t tick_started_at = 0;
+#	endif //!ATMOS_PREEMPTIVE
 #endif //ATMOS_SUPPORT_SLEEP
 
+#if ATMOS_SUPPORT_SUSPEND
+///List of suspended processes, which would be running otherwise.
+process_list suspended_processes{};
+#endif //ATMOS_SUPPORT_SUSPEND
+
+#if ATMOS_SUPPORT_PREEMPTION_THRESHOLD && ATMOS_KERNEL_AWARE_ISR
+///Set when ATMOS_ISR interrupt handler switches context on exit. Cleared on each context switch.
+volatile bool preempted_by_interrupt asm("atmos_preempted_by_interrupt") ATMOS_USED = false;
+#endif //ATMOS_SUPPORT_PREEMPTION_THRESHOLD && ATMOS_KERNEL_AWARE_ISR
+
+#if ATMOS_SUPPORT_STATISTICS
+///Collected kernel statistics.
+atmos::kernel::statistics statistics{};
+///Reason of the next context switch, which is not caused by scheduler tick.
+///Reset to yield on each context switch.
+atmos::kernel::switch_reason switch_reason asm("atmos_switch_reason") ATMOS_USED
+	= atmos::kernel::switch_reason::yield;
+#endif //ATMOS_SUPPORT_STATISTICS
+
+#if ATMOS_SUPPORT_CPU_LOAD
+///Scheduler timer counts spent in system process during current measurement window.
+uint32_t idle_counts = 0;
+///Smoothed scheduler timer counts spent in system process per measurement window.
+uint32_t smoothed_idle_counts = 0;
+///Scheduler timer counter value, when system process was switched to.
+uint16_t idle_since = 0;
+///Number of ticks passed in current measurement window.
+uint8_t window_ticks = 0;
+///Set when the first measurement window is completed.
+bool cpu_load_measured = false;
+#endif //ATMOS_SUPPORT_CPU_LOAD
+
+#if ATMOS_SUPPORT_PROCESS_DESCRIPTORS
+///Process descriptor table in program memory (see process::create_all).
+const atmos::process_descriptor* process_table = nullptr;
+uint8_t process_table_size = 0;
+#endif //ATMOS_SUPPORT_PROCESS_DESCRIPTORS
+
+#if ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+///Current scheduler tick period in microseconds.
+uint32_t tick_period_us = ATMOS_TICK_PERIOD_US;
+#endif //ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+
+///<summary>Converts any process list element to process ID.</summary>
+///<param name="elem">process_list_element, process_list_element_tagged or forward_list_element pointer.</param>
+///<returns>Process ID.</returns>
+template<typename ListElement>
+atmos::process::id_type to_pid(ListElement* elem)
+{
+	//Process ID is essentially pointer to its process_list_element.
+	static_assert(sizeof(process_list_element*) == sizeof(atmos::process::id_type),
+		"Unsupported pointer type size");
+	return reinterpret_cast<atmos::process::id_type>(static_cast<process_list_element*>(elem));
+}
+
+///<summary>Converts process ID to process list element.</summary>
+///<param name="pid">Process ID.</param>
+///<returns>Process list element.</returns>
+process_list_element* from_pid(atmos::process::id_type pid)
+{
+	return reinterpret_cast<process_list_element*>(pid);
+}
+
+#if ATMOS_STACK_OVERFLOW_CHECK
+///<summary>Returns pointer to process stack canary word.</summary>
+///<param name="process">Process list element. Can not be nullptr.</param>
+///<returns>Pointer to canary word, which is located right after process control block.</returns>
+ATMOS_ALWAYS_INLINE uint16_t* get_stack_canary(process_list_element_tagged* process)
+{
+	return reinterpret_cast<uint16_t*>(static_cast<process_list_element*>(process) + 1);
+}
+
+///<summary>Checks process stack canary and saved stack pointer.
+///         Calls kernel::stack_overflow_hook if process stack has overflown.</summary>
+///<param name="process">Process list element. Can not be nullptr.</param>
+///<param name="stack_pointer">Saved process stack pointer.</param>
+void ATMOS_ALWAYS_INLINE check_process_stack(process_list_element_tagged* process,
+	atmos::process::stack_pointer_type stack_pointer)
+{
+	auto* canary = get_stack_canary(process);
+	//Stack pointer points to the first free stack byte, so it may point to the last canary byte
+	//when the stack is full.
+	if(*canary != atmos::process::stack_canary_value
+		|| reinterpret_cast<uint16_t>(canary) + atmos::process::stack_canary_size > stack_pointer + 1u)
+	{
+		atmos::kernel::stack_overflow_hook(to_pid(process));
+	}
+}
+#endif //ATMOS_STACK_OVERFLOW_CHECK
+
 #if ATMOS_SUPPORT_SLEEP
+///<summary>Adds process to the list of running processes. If priorities are enabled, process is inserted
+///         after all processes with the same or higher priority, otherwise it is inserted to the front of the list.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+///<param name="process">Process not attached to any list. Can not be nullptr.</param>
+void ATMOS_ALWAYS_INLINE insert_running_process(process_list_element_tagged* process)
+{
+	(*process)->process.list = atmos::process::process_list_type::running;
+#	if ATMOS_SUPPORT_PRIORITIES
+	//Function is inlined to scheduler, so list is traversed manually without functor, which may require stack frame.
+	auto priority = (*process)->process.priority;
+	process_list_element_tagged* prev = nullptr;
+	auto* current = running_processes.first();
+	while(current && (*current)->process.priority >= priority)
+	{
+		prev = current;
+		current = process_list::next(current);
+	}
+	
+	if(prev)
+		running_processes.insert_after(prev, process);
+	else
+		running_processes.push_front(process);
+#	else //ATMOS_SUPPORT_PRIORITIES
+	running_processes.push_front(process);
+#	endif //ATMOS_SUPPORT_PRIORITIES
+}
+
+///<summary>Inserts process to the list of running processes after current process, so that it is run next,
+///         while round-robin order of other processes is kept.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+///<param name="current">Current process, which is contained in the list of running processes. Can not be nullptr.</param>
+///<param name="process">Process not attached to any list. Can not be nullptr.</param>
+void ATMOS_ALWAYS_INLINE insert_next_running_process(process_list_element_tagged* current,
+	process_list_element_tagged* process)
+{
+	(*process)->process.list = atmos::process::process_list_type::running;
+	running_processes.insert_after(current, process);
+	next_process = process;
+}
+
+#	if ATMOS_SUPPORT_SUSPEND
+///<summary>Adds process to the list of suspended processes.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+///<param name="process">Process not attached to any list. Can not be nullptr.</param>
+void ATMOS_ALWAYS_INLINE insert_suspended_process(process_list_element_tagged* process)
+{
+	(*process)->process.list = atmos::process::process_list_type::suspended;
+	suspended_processes.push_front(process);
+}
+#	endif //ATMOS_SUPPORT_SUSPEND
+
+///<summary>Marks process woken up by scheduler tick.</summary>
+///<param name="process">Process removed from the list of sleeping processes. Can not be nullptr.</param>
+void ATMOS_ALWAYS_INLINE mark_woken_up_by_tick(process_list_element_tagged* process)
+{
+	auto& control_block = (*process)->process;
+	if(control_block.timed_wait == atmos::process::timed_wait_state::waiting)
+		control_block.timed_wait = atmos::process::timed_wait_state::timed_out;
+#	if ATMOS_SUPPORT_STATISTICS
+	control_block.wake_up_pending = true;
+#	endif //ATMOS_SUPPORT_STATISTICS
+}
+
 ///<summary>Increments tick count and wakes up required processes.</summary>
 void ATMOS_ALWAYS_INLINE tick_and_wake_up_processes()
 {
@@ -55,6 +230,26 @@ void ATMOS_ALWAYS_INLINE tick_and_wake_up_processes()
 		waiting_processes_overflown = temp;
 	}
 	
+#	if ATMOS_SUPPORT_SUSPEND || ATMOS_SUPPORT_PRIORITIES
+	//Woken up processes are inserted one by one to keep priority order or to skip suspended processes.
+	while(auto* current = waiting_processes.first())
+	{
+		if(tick_counter < (*current)->process.sleep_until)
+			break;
+		
+		waiting_processes.pop_front();
+		mark_woken_up_by_tick(current);
+#		if ATMOS_SUPPORT_SUSPEND
+		if((*current)->process.suspended)
+		{
+			insert_suspended_process(current);
+			continue;
+		}
+#		endif //ATMOS_SUPPORT_SUSPEND
+		
+		insert_running_process(current);
+	}
+#	else //ATMOS_SUPPORT_SUSPEND || ATMOS_SUPPORT_PRIORITIES
 	process_list_element_tagged* prev = nullptr;
 	process_list_element_tagged* current = waiting_processes.first();
 	while(current)
@@ -62,45 +257,239 @@ void ATMOS_ALWAYS_INLINE tick_and_wake_up_processes()
 		if(tick_counter < (*current)->process.sleep_until)
 			break;
 		
+		mark_woken_up_by_tick(current);
+		(*current)->process.list = atmos::process::process_list_type::running;
 		prev = current;
 		current = process_list::next(current);
 	}
 	
 	if(prev)
+		running_processes.splice_front(waiting_processes, prev);
+#	endif //ATMOS_SUPPORT_SUSPEND || ATMOS_SUPPORT_PRIORITIES
+}
+
+#	if ATMOS_SUPPORT_PREEMPTION_THRESHOLD
+///<summary>Returns true if preempted process must continue to run instead of process with specified priority.</summary>
+///<param name="process">Preempted process, which is contained in the list of running processes. Can not be nullptr.</param>
+///<param name="priority">Priority of the highest priority running process.</param>
+///<returns>True if process preemption threshold is above its priority and is not below specified priority.</returns>
+bool ATMOS_ALWAYS_INLINE is_protected_from_preemption(process_list_element_tagged* process,
+	atmos::process::priority_type priority)
+{
+	auto threshold = (*process)->process.preemption_threshold;
+	return threshold > (*process)->process.priority && priority <= threshold;
+}
+#	endif //ATMOS_SUPPORT_PREEMPTION_THRESHOLD
+
+#	if ATMOS_SUPPORT_PRIORITIES && ATMOS_PREEMPTIVE
+///<summary>Requests context switch on kernel_lock release in process context, if the highest priority
+///         running process has priority above current process priority (and preemption threshold, if enabled).
+///         Otherwise cancels the request, for example, when preemption threshold is raised.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+void check_preemption()
+{
+	auto* current = current_process;
+	auto* first = running_processes.first();
+	bool preempted = current && first;
+#		if ATMOS_ENABLE_SYSTEM_PROCESS
+	if(preempted && current != system_process)
+#		else //ATMOS_ENABLE_SYSTEM_PROCESS
+	if(preempted)
+#		endif //ATMOS_ENABLE_SYSTEM_PROCESS
 	{
-		process_list::set_next(prev, running_processes.first());
-		running_processes.set_first(waiting_processes.first());
-		waiting_processes.set_first(current);
+		auto priority = (*first)->process.priority;
+#		if ATMOS_SUPPORT_PREEMPTION_THRESHOLD
+		preempted = priority > (*current)->process.priority && !is_protected_from_preemption(current, priority);
+#		else //ATMOS_SUPPORT_PREEMPTION_THRESHOLD
+		preempted = priority > (*current)->process.priority;
+#		endif //ATMOS_SUPPORT_PREEMPTION_THRESHOLD
 	}
+	
+	atmos::detail::preemption_requested = preempted;
+}
+#	endif //ATMOS_SUPPORT_PRIORITIES && ATMOS_PREEMPTIVE
+
+///<summary>Adds process to the list of running processes, so that it is run next to the current process.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+///<param name="process">Process not attached to any list. Can not be nullptr.</param>
+void wake_up_process(process_list_element_tagged* process) ATMOS_NONNULL(1);
+void wake_up_process(process_list_element_tagged* process)
+{
+#	if ATMOS_SUPPORT_SUSPEND
+	if((*process)->process.suspended)
+	{
+		insert_suspended_process(process);
+		return;
+	}
+#	endif //ATMOS_SUPPORT_SUSPEND
+	
+#	if ATMOS_SUPPORT_PRIORITIES
+	//Scheduler switches to woken up process, if it has higher priority than current process.
+	insert_running_process(process);
+#	else //ATMOS_SUPPORT_PRIORITIES
+	auto* current = current_process;
+#		if ATMOS_ENABLE_SYSTEM_PROCESS
+	if(current == system_process)
+		current = nullptr;
+#		endif //ATMOS_ENABLE_SYSTEM_PROCESS
+	
+	if(current)
+		insert_next_running_process(current, process);
+	else
+		insert_running_process(process);
+#	endif //ATMOS_SUPPORT_PRIORITIES
+	
+	reschedule_requested = true;
+#	if ATMOS_SUPPORT_PRIORITIES && ATMOS_PREEMPTIVE
+	check_preemption();
+#	endif //ATMOS_SUPPORT_PRIORITIES && ATMOS_PREEMPTIVE
 }
 #endif //ATMOS_SUPPORT_SLEEP
 
+#if ATMOS_SUPPORT_STATISTICS
+///<summary>Increments histogram bucket.</summary>
+///<param name="histogram">Histogram.</param>
+///<param name="bucket">Bucket index, which is limited to the last bucket.</param>
+void ATMOS_ALWAYS_INLINE add_to_histogram(uint16_t (&histogram)[ATMOS_STATISTICS_HISTOGRAM_SIZE], uint8_t bucket)
+{
+	if(bucket > ATMOS_STATISTICS_HISTOGRAM_SIZE - 1)
+		bucket = ATMOS_STATISTICS_HISTOGRAM_SIZE - 1;
+	
+	++histogram[bucket];
+}
+
+///<summary>Updates kernel statistics on context switch.</summary>
+///<param name="previous">Previously running process. Can be nullptr.</param>
+///<param name="next">Process to be run next. Can be nullptr.</param>
+///<param name="increment_tick_count">Non-zero if context switch is performed by scheduler tick.</param>
+void ATMOS_ALWAYS_INLINE update_statistics(process_list_element_tagged* previous,
+	process_list_element_tagged* next, uint8_t increment_tick_count)
+{
+	auto reason = switch_reason;
+	switch_reason = atmos::kernel::switch_reason::yield;
+	if(increment_tick_count)
+	{
+		reason = atmos::kernel::switch_reason::tick;
+		//Scheduler timer counter is reset on compare match, when scheduler interrupt is requested.
+		uint16_t duration = atmos::get_scheduler_timer_counter();
+		if(duration > statistics.max_scheduler_duration)
+			statistics.max_scheduler_duration = duration;
+		
+		uint8_t bucket = 0;
+		for(; duration; duration >>= 1)
+			++bucket;
+		
+		add_to_histogram(statistics.scheduler_duration_histogram, bucket);
+	}
+	
+	if(previous == next || !next)
+		return;
+	
+	++statistics.context_switches[static_cast<uint8_t>(reason)];
+	auto& process = (*next)->process;
+	++process.run_count;
+	if(process.wake_up_pending)
+	{
+		process.wake_up_pending = false;
+		auto delay = static_cast<atmos::process::tick_t>(tick_counter - process.sleep_until);
+		if(delay > statistics.max_wake_up_delay)
+			statistics.max_wake_up_delay = delay;
+		
+		add_to_histogram(statistics.wake_up_delay_histogram,
+			delay > ATMOS_STATISTICS_HISTOGRAM_SIZE ? ATMOS_STATISTICS_HISTOGRAM_SIZE : static_cast<uint8_t>(delay));
+	}
+}
+#endif //ATMOS_SUPPORT_STATISTICS
+
+#if ATMOS_SUPPORT_CPU_LOAD
+///<summary>Accounts time spent in system process on context switch.</summary>
+///<remarks>Not inlined, as 32-bit arithmetic may require stack frame, which is not allowed in scheduler.</remarks>
+///<param name="previous">Previously running process. Can be nullptr.</param>
+///<param name="next">Process to be run next. Can not be nullptr.</param>
+///<param name="increment_tick_count">Non-zero if context switch is performed by scheduler tick.</param>
+void ATMOS_NOINLINE update_cpu_load(process_list_element_tagged* previous,
+	process_list_element_tagged* next, uint8_t increment_tick_count);
+#endif //ATMOS_SUPPORT_CPU_LOAD
+
+#if ATMOS_SUPPORT_SLEEP && !ATMOS_PREEMPTIVE
+///<summary>Advances tick count by the number of ticks passed since the last call according to
+///         free-running scheduler timer counter, and wakes up required processes.</summary>
+///<remarks>Expects that interrupts are disabled. Not inlined, as it may require stack frame,
+///which is not allowed in scheduler.</remarks>
+void ATMOS_NOINLINE advance_tick_count();
+#endif //ATMOS_SUPPORT_SLEEP && !ATMOS_PREEMPTIVE
+
 ///<summary>Performs process context switch preparations. Decides which process will run next.</summary>
+///<remarks>Current process stack pointer is passed as an argument, so that saved value is not affected
+///by registers which may be pushed in scheduler prologue (see process::scheduler_stack_size).</remarks>
 ///<returns>Stack pointer of a process to be run next.</returns>
-#if ATMOS_SUPPORT_SLEEP
-atmos::process::stack_pointer_type ATMOS_HOT ATMOS_USED save_sp_and_choose_next_process(uint8_t increment_tick_count)
+#if ATMOS_SCHEDULER_TICK_FLAG
+atmos::process::stack_pointer_type ATMOS_HOT ATMOS_USED save_sp_and_choose_next_process(
+	atmos::process::stack_pointer_type process_stack_pointer, uint8_t increment_tick_count)
 	asm("save_sp_and_choose_next_process");
-atmos::process::stack_pointer_type save_sp_and_choose_next_process(uint8_t increment_tick_count)
-#else //ATMOS_SUPPORT_SLEEP
-atmos::process::stack_pointer_type ATMOS_HOT ATMOS_USED save_sp_and_choose_next_process()
-asm("save_sp_and_choose_next_process");
-atmos::process::stack_pointer_type save_sp_and_choose_next_process()
-#endif //ATMOS_SUPPORT_SLEEP
+atmos::process::stack_pointer_type save_sp_and_choose_next_process(
+	atmos::process::stack_pointer_type process_stack_pointer, uint8_t increment_tick_count)
+#else //ATMOS_SCHEDULER_TICK_FLAG
+atmos::process::stack_pointer_type ATMOS_HOT ATMOS_USED save_sp_and_choose_next_process(
+	atmos::process::stack_pointer_type process_stack_pointer)
+	asm("save_sp_and_choose_next_process");
+atmos::process::stack_pointer_type save_sp_and_choose_next_process(
+	atmos::process::stack_pointer_type process_stack_pointer)
+#endif //ATMOS_SCHEDULER_TICK_FLAG
 {
-#if ATMOS_SUPPORT_SLEEP
+#if ATMOS_SCHEDULER_TICK_FLAG
 	if(increment_tick_count)
 		tick_and_wake_up_processes();
-#endif //ATMOS_SUPPORT_SLEEP
+#elif ATMOS_SUPPORT_SLEEP
+	advance_tick_count();
+#endif //ATMOS_SCHEDULER_TICK_FLAG
 	
 	process_list_element_tagged* current;
 #if ATMOS_SUPPORT_SLEEP
+	reschedule_requested = false;
+#	if ATMOS_SUPPORT_PRIORITIES && ATMOS_PREEMPTIVE
+	atmos::detail::preemption_requested = false;
+#	endif //ATMOS_SUPPORT_PRIORITIES && ATMOS_PREEMPTIVE
 	current = current_process;
 	if(current)
-		(*current)->process.stack_pointer = SP;
+	{
+		(*current)->process.stack_pointer = process_stack_pointer;
+#	if ATMOS_STACK_OVERFLOW_CHECK
+		check_process_stack(current, (*current)->process.stack_pointer);
+#	endif //ATMOS_STACK_OVERFLOW_CHECK
+	}
 	
 	current = next_process;
+#	if ATMOS_SUPPORT_PRIORITIES
+	//Only processes with the highest priority among running processes are run in round-robin order.
+	//List of running processes is sorted by priority, so next process has lower priority when the end of
+	//highest priority processes is reached.
+	auto* first = running_processes.first();
+#		if ATMOS_SUPPORT_PREEMPTION_THRESHOLD
+	//Process preempted by scheduler tick or ATMOS_ISR interrupt handler is still contained in the list
+	//of running processes, and continues to run, if no running process has priority above its preemption threshold.
+	//Process which yields, sleeps or waits switches context voluntarily, so its threshold is ignored.
+	auto* previous = current_process;
+#			if ATMOS_KERNEL_AWARE_ISR
+	bool preempted = increment_tick_count || preempted_by_interrupt;
+	preempted_by_interrupt = false;
+#			else //ATMOS_KERNEL_AWARE_ISR
+	bool preempted = increment_tick_count;
+#			endif //ATMOS_KERNEL_AWARE_ISR
+#			if ATMOS_ENABLE_SYSTEM_PROCESS
+	if(previous == system_process)
+		preempted = false;
+#			endif //ATMOS_ENABLE_SYSTEM_PROCESS
+	if(preempted && previous && is_protected_from_preemption(previous, (*first)->process.priority))
+		current = previous;
+	else
+#		endif //ATMOS_SUPPORT_PREEMPTION_THRESHOLD
+	if(!current || (*current)->process.priority < (*first)->process.priority)
+		current = first;
+#	else //ATMOS_SUPPORT_PRIORITIES
 	if(!current)
 		current = running_processes.first();
+#	endif //ATMOS_SUPPORT_PRIORITIES
 	
 	if(current)
 	{
@@ -121,7 +510,10 @@ atmos::process::stack_pointer_type save_sp_and_choose_next_process()
 	}
 	else
 	{
-		(*current)->process.stack_pointer = SP;
+		(*current)->process.stack_pointer = process_stack_pointer;
+#	if ATMOS_STACK_OVERFLOW_CHECK
+		check_process_stack(current, (*current)->process.stack_pointer);
+#	endif //ATMOS_STACK_OVERFLOW_CHECK
 		current = process_list::next(current);
 		//If we do not have next process to run, just take the first one available.
 		if(!current)
@@ -129,6 +521,13 @@ atmos::process::stack_pointer_type save_sp_and_choose_next_process()
 	}
 #endif //ATMOS_SUPPORT_SLEEP
 
+#if ATMOS_SUPPORT_STATISTICS
+	update_statistics(current_process, current, increment_tick_count);
+#endif //ATMOS_SUPPORT_STATISTICS
+#if ATMOS_SUPPORT_CPU_LOAD
+	update_cpu_load(current_process, current, increment_tick_count);
+#endif //ATMOS_SUPPORT_CPU_LOAD
+
 	//Save current process pointer.
 	current_process = current;
 	
@@ -139,21 +538,179 @@ atmos::process::stack_pointer_type save_sp_and_choose_next_process()
 //This is needed to ensure that choose_next_process() stack frame size is zero.
 #pragma GCC diagnostic ignored "-Wframe-larger-than="
 
-///<summary>Converts any process list element to process ID.</summary>
-///<param name="elem">process_list_element, process_list_element_tagged or forward_list_element pointer.</param>
-///<returns>Process ID.</returns>
-template<typename ListElement>
-atmos::process::id_type to_pid(ListElement* elem)
+#if ATMOS_SUPPORT_SLEEP
+///<summary>Adds process to the list of waiting processes.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+///<param name="process">Process not attached to any list. Can not be nullptr.</param>
+///<param name="ticks">Number of ticks to sleep for. Must be greater than zero.</param>
+void put_process_to_sleep(process_list_element_tagged* process, atmos::process::tick_t ticks) ATMOS_NONNULL(1);
+void put_process_to_sleep(process_list_element_tagged* process, atmos::process::tick_t ticks)
 {
-	//Process ID is essentially pointer to its process_list_element.
-	static_assert(sizeof(process_list_element*) == sizeof(atmos::process::id_type),
-		"Unsupported pointer type size");
-	return reinterpret_cast<atmos::process::id_type>(static_cast<process_list_element*>(elem));
+#	if !ATMOS_PREEMPTIVE
+	//Tick count is advanced only on kernel calls in cooperative mode, so sleep is counted from the current tick.
+	advance_tick_count();
+#	endif //!ATMOS_PREEMPTIVE
+	atmos::process::tick_t sleep_until = tick_counter + ticks;
+	(*process)->process.sleep_until = sleep_until;
+	(*process)->process.list = atmos::process::process_list_type::sleeping;
+	
+	auto& target_list = sleep_until < ticks ? waiting_processes_overflown : waiting_processes;
+	target_list.insert_before(process, [sleep_until](const auto* before)
+	{
+		return before->process.sleep_until > sleep_until;
+	});
+}
+
+///<summary>Removes process from the list of sleeping processes.</summary>
+///<remarks>Expects that interrupts are disabled. Has O(1) time complexity
+///with ATMOS_DOUBLY_LINKED_PROCESS_LISTS, and O(n) otherwise.</remarks>
+///<param name="process">Sleeping process. Can not be nullptr.</param>
+void remove_sleeping_process(process_list_element_tagged* process) ATMOS_NONNULL(1);
+void remove_sleeping_process(process_list_element_tagged* process)
+{
+#	if ATMOS_DOUBLY_LINKED_PROCESS_LISTS
+	//Processes which sleep past the current tick are woken up before tick counter overflows,
+	//so only processes sleeping until tick counter overflow have earlier wake up time.
+	auto& list = (*process)->process.sleep_until > tick_counter ? waiting_processes : waiting_processes_overflown;
+	list.remove(process);
+#	else //ATMOS_DOUBLY_LINKED_PROCESS_LISTS
+	if(!waiting_processes.remove(process))
+		waiting_processes_overflown.remove(process);
+#	endif //ATMOS_DOUBLY_LINKED_PROCESS_LISTS
+}
+
+///<summary>Wakes up process removed from wait list.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+///<param name="waiter">Process removed from wait list. Can not be nullptr.</param>
+void wake_up_waiter(process_list_element* waiter) ATMOS_NONNULL(1);
+void wake_up_waiter(process_list_element* waiter)
+{
+	auto& timed_wait = waiter->process.timed_wait;
+	if(timed_wait == atmos::process::timed_wait_state::timed_out)
+	{
+		//Timeout has already expired, and process is in the list of running (or suspended) processes,
+		//but has not run yet. It will see the notification.
+		timed_wait = atmos::process::timed_wait_state::notified;
+		return;
+	}
+	
+	if(timed_wait == atmos::process::timed_wait_state::waiting)
+	{
+		timed_wait = atmos::process::timed_wait_state::notified;
+		remove_sleeping_process(waiter);
+	}
+	
+	wake_up_process(waiter);
+}
+
+///<summary>Removes process from the list of running processes, if it is contained there.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+///<param name="process">Any process. Can not be nullptr.</param>
+///<returns>True if process was removed. False if process is not running.</returns>
+bool remove_running_process(process_list_element_tagged* process) ATMOS_NONNULL(1);
+bool remove_running_process(process_list_element_tagged* process)
+{
+	if((*process)->process.list != atmos::process::process_list_type::running)
+		return false;
+	
+	//Scheduler expects that process to be run next is contained in the list of running processes.
+	if(next_process == process)
+		next_process = process_list::next(process);
+	
+	running_processes.remove(process);
+	(*process)->process.list = atmos::process::process_list_type::none;
+	return true;
+}
+
+#	if ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+///<summary>Converts tick count to the tick count for different tick period. Result is rounded up.</summary>
+///<param name="ticks">Number of ticks.</param>
+///<param name="from_tick_period_us">Tick period of ticks value.</param>
+///<param name="to_tick_period_us">Tick period to convert to.</param>
+///<returns>Converted tick count, limited to the maximal tick counter value.</returns>
+atmos::process::tick_t rescale_ticks(atmos::process::tick_t ticks,
+	uint32_t from_tick_period_us, uint32_t to_tick_period_us)
+{
+	constexpr auto max_ticks = static_cast<atmos::process::tick_t>(~atmos::process::tick_t{});
+	uint32_t microseconds = ticks > UINT32_MAX / from_tick_period_us
+		? UINT32_MAX : static_cast<uint32_t>(ticks * from_tick_period_us);
+	uint32_t result = microseconds / to_tick_period_us;
+	if(microseconds % to_tick_period_us)
+		++result;
+	
+	return result > max_ticks ? max_ticks : static_cast<atmos::process::tick_t>(result);
+}
+
+///<summary>Recalculates wake up times of sleeping processes after tick period change.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+///<param name="from_tick_period_us">Previous tick period.</param>
+///<param name="to_tick_period_us">New tick period.</param>
+void rescale_sleeping_processes(uint32_t from_tick_period_us, uint32_t to_tick_period_us)
+{
+	process_list sleeping_processes[] = { waiting_processes, waiting_processes_overflown };
+	waiting_processes = process_list{};
+	waiting_processes_overflown = process_list{};
+	
+	for(auto& list : sleeping_processes)
+	{
+		while(auto* process = list.pop_front())
+		{
+			//Sleeping process wake up time is always after current tick, even if the tick counter overflows.
+			auto ticks = static_cast<atmos::process::tick_t>((*process)->process.sleep_until - tick_counter);
+			put_process_to_sleep(process, rescale_ticks(ticks, from_tick_period_us, to_tick_period_us));
+		}
+	}
 }
+#	endif //ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+#endif //ATMOS_SUPPORT_SLEEP
+
+#if ATMOS_SUPPORT_SLEEP && !ATMOS_PREEMPTIVE
+void advance_tick_count()
+{
+	uint16_t elapsed = (atmos::get_scheduler_timer_counter() - tick_started_at)
+		& atmos::detail::scheduler_timer_max_value;
+	while(elapsed >= ATMOS_TIMER_TOP_VALUE)
+	{
+		elapsed -= ATMOS_TIMER_TOP_VALUE;
+		tick_started_at += ATMOS_TIMER_TOP_VALUE;
+		tick_and_wake_up_processes();
+	}
+}
+#endif //ATMOS_SUPPORT_SLEEP && !ATMOS_PREEMPTIVE
+
+#if ATMOS_SUPPORT_CPU_LOAD
+void update_cpu_load(process_list_element_tagged* previous,
+	process_list_element_tagged* next, uint8_t increment_tick_count)
+{
+	//Scheduler timer counter is reset on compare match, when scheduler interrupt is requested.
+	uint16_t now = atmos::get_scheduler_timer_counter();
+	if(previous == system_process)
+	{
+		if(increment_tick_count)
+			idle_counts += static_cast<uint32_t>(atmos::get_scheduler_timer_top()) + 1 - idle_since;
+		else if(now > idle_since) //Counter may be already reset, if scheduler interrupt is pending.
+			idle_counts += now - idle_since;
+	}
+	
+	if(increment_tick_count && ++window_ticks == ATMOS_CPU_LOAD_WINDOW_TICKS)
+	{
+		smoothed_idle_counts = cpu_load_measured
+			? smoothed_idle_counts - smoothed_idle_counts / 4 + idle_counts / 4
+			: idle_counts;
+		cpu_load_measured = true;
+		idle_counts = 0;
+		window_ticks = 0;
+	}
+	
+	if(next == system_process)
+		idle_since = now;
+}
+#endif //ATMOS_SUPPORT_CPU_LOAD
 
 ///<summary>Switches process context and runs next available process.</summary>
 ///<remarks>This function expects that interrupts are disabled.
-///Currently running process context should be already saved before this function is called.</remarks>
+///Currently running process R31 and SREG (or only SREG in cooperative mode) should be already saved
+///before this function is called.</remarks>
 void ATMOS_HOT ATMOS_NAKED ATMOS_USED save_context_and_switch_to_next_process_context_func()
 	asm("save_context_and_switch_to_next_process_context_func");
 ///Helper macro that just jumps to switch_to_next_process_context_func function and contains a memory barrier.
@@ -161,26 +718,53 @@ void ATMOS_HOT ATMOS_NAKED ATMOS_USED save_context_and_switch_to_next_process_co
 	(ATMOS_JUMP "save_context_and_switch_to_next_process_context_func" ::: "memory")
 void save_context_and_switch_to_next_process_context_func()
 {
+#if ATMOS_PREEMPTIVE
 	save_context_except_r31_and_sreg();
+#else //ATMOS_PREEMPTIVE
+	save_call_saved_context();
+#endif //ATMOS_PREEMPTIVE
 	
 	//Switch to next process
 	//and set the stack pointer register value to the stack pointer of that process.
 	__asm__ __volatile__ (
+#if ATMOS_USE_INTERRUPT_STACK
+		//Pass process stack pointer to scheduler and switch to interrupt stack.
+		"in r24, __SP_L__                           \n\t"
+#	if !defined(__AVR_HAVE_8BIT_SP__) && !defined(__AVR_SP8__)
+		"in r25, __SP_H__                           \n\t"
+		"ldi r31, hi8(" STRINGIFY(RAMEND) ")        \n\t"
+		"out __SP_H__, r31                          \n\t"
+#	endif //16-bit stack
+		"ldi r30, lo8(" STRINGIFY(RAMEND) ")        \n\t"
+		"out __SP_L__, r30                          \n\t"
+#	if ATMOS_SCHEDULER_TICK_FLAG
+		"clr r22                                    \n\t"
+		"bld r22, 0                                 \n\t"
+#	endif //ATMOS_SCHEDULER_TICK_FLAG
+		ATMOS_CALL "save_sp_and_choose_next_process \n\t"
+#else //ATMOS_USE_INTERRUPT_STACK
+		//Pass process stack pointer to scheduler. Registers R28, R29 and R2 are already saved and are call-saved,
+		//so they are used to keep context bytes overwritten by scheduler return address.
+		"in r24, __SP_L__                           \n\t"
+#	if !defined(__AVR_HAVE_8BIT_SP__) && !defined(__AVR_SP8__)
+		"in r25, __SP_H__                           \n\t"
+#	endif //16-bit stack
 		"pop r28                                    \n\t"
 		"pop r29                                    \n\t"
-#ifdef __AVR_3_BYTE_PC__
+#	ifdef __AVR_3_BYTE_PC__
 		"pop r2                                     \n\t"
-#endif //__AVR_3_BYTE_PC__
-#if ATMOS_SUPPORT_SLEEP
-		"clr r24                                    \n\t"
-		"bld r24, 0                                 \n\t"
-#endif //ATMOS_SUPPORT_SLEEP
+#	endif //__AVR_3_BYTE_PC__
+#	if ATMOS_SCHEDULER_TICK_FLAG
+		"clr r22                                    \n\t"
+		"bld r22, 0                                 \n\t"
+#	endif //ATMOS_SCHEDULER_TICK_FLAG
 		ATMOS_CALL "save_sp_and_choose_next_process \n\t"
-#ifdef __AVR_3_BYTE_PC__
+#	ifdef __AVR_3_BYTE_PC__
 		"push r2                                    \n\t"
-#endif //__AVR_3_BYTE_PC__
+#	endif //__AVR_3_BYTE_PC__
 		"push r29                                   \n\t"
 		"push r28                                   \n\t"
+#endif //ATMOS_USE_INTERRUPT_STACK
 		"switch_to_stack:                           \n\t"
 #if !defined(__AVR_HAVE_8BIT_SP__) && !defined(__AVR_SP8__)
 		"out __SP_H__, r25                          \n\t"
@@ -190,11 +774,73 @@ void save_context_and_switch_to_next_process_context_func()
 	);
 	
 	//Now restore process context and run that process.
+#if ATMOS_PREEMPTIVE
 	restore_context_except_r31_and_sreg();
 	restore_r31_and_sreg_and_switch_context();
+#else //ATMOS_PREEMPTIVE
+	restore_call_saved_context();
+	restore_sreg_and_switch_context();
+#endif //ATMOS_PREEMPTIVE
+}
+
+#if ATMOS_KERNEL_AWARE_ISR && ATMOS_SUPPORT_SLEEP && ATMOS_PREEMPTIVE
+///<summary>Switches context on ATMOS_ISR interrupt handler exit. Interrupted process context
+///         is saved like it is done by scheduler interrupt, but tick count is not incremented.</summary>
+///<remarks>Jumped to from atmos_interrupt_entry with interrupts disabled and return address
+///to interrupted process on stack.</remarks>
+void ATMOS_NAKED ATMOS_USED reschedule_from_interrupt() asm("atmos_reschedule_from_interrupt");
+void reschedule_from_interrupt()
+{
+	save_r31_and_sreg_from_scheduler();
+	
+	__asm__ __volatile__ (
+#	if ATMOS_SUPPORT_STATISTICS
+		//R31 is already saved.
+		"ldi r31, %0                    \n\t"
+		"sts atmos_switch_reason, r31   \n\t"
+#	endif //ATMOS_SUPPORT_STATISTICS
+#	if ATMOS_SUPPORT_PREEMPTION_THRESHOLD
+		"ldi r31, 1                     \n\t"
+		"sts atmos_preempted_by_interrupt, r31 \n\t"
+#	endif //ATMOS_SUPPORT_PREEMPTION_THRESHOLD
+		"clt                            \n\t"
+#	if ATMOS_SUPPORT_STATISTICS
+		:: "M" (static_cast<uint8_t>(atmos::kernel::switch_reason::interrupt))
+#	else //ATMOS_SUPPORT_STATISTICS
+		::
+#	endif //ATMOS_SUPPORT_STATISTICS
+	);
+	
+	save_context_and_switch_to_next_process_context();
 }
+#endif //ATMOS_KERNEL_AWARE_ISR && ATMOS_SUPPORT_SLEEP && ATMOS_PREEMPTIVE
+
+#if ATMOS_USE_INTERRUPT_STACK
+///Stack pointer of process interrupted by ATMOS_ISR interrupt handler.
+atmos::process::stack_pointer_type interrupted_stack_pointer
+	asm("atmos_interrupted_stack_pointer") ATMOS_USED = 0;
+#endif //ATMOS_USE_INTERRUPT_STACK
 
 #if ATMOS_ENABLE_SYSTEM_PROCESS
+#	if ATMOS_SUPPORT_IDLE_HOOK || !ATMOS_PREEMPTIVE
+void ATMOS_OS_TASK ATMOS_NORETURN system_process_entry_point()
+{
+	while(true)
+	{
+#		if ATMOS_SUPPORT_IDLE_HOOK
+		atmos::kernel::idle_hook();
+#		endif //ATMOS_SUPPORT_IDLE_HOOK
+#		if !ATMOS_PREEMPTIVE
+		//There is no scheduler tick in cooperative mode, so system process yields to processes
+		//woken up by interrupt handlers or by tick count advance.
+		atmos::process::yield();
+#		endif //!ATMOS_PREEMPTIVE
+	}
+}
+
+///System process stack size.
+constexpr size_t system_process_stack_size = ATMOS_SYSTEM_PROCESS_STACK_SIZE;
+#	else //ATMOS_SUPPORT_IDLE_HOOK || !ATMOS_PREEMPTIVE
 void ATMOS_NAKED system_process_entry_point()
 {
 	__asm__ __volatile__ (
@@ -202,6 +848,10 @@ void ATMOS_NAKED system_process_entry_point()
 		::
 	);
 }
+
+///System process stack size.
+constexpr size_t system_process_stack_size = 0;
+#	endif //ATMOS_SUPPORT_IDLE_HOOK || !ATMOS_PREEMPTIVE
 #endif //ATMOS_ENABLE_SYSTEM_PROCESS
 
 ///<summary>Push address to the bottom of the process stack.</summary>
@@ -223,7 +873,8 @@ uint8_t* push_function_address(const void* address, uint8_t* stack_bottom)
 
 ///<summary>Prepare new process context.</summary>
 ///<remarks>Assumes that stack memory is zero-filled. Pushes
-///return address to process entry point, all general purpose register values and SREG value.</remarks>
+///return address to process entry point, all general purpose register values and SREG value
+///(only call-saved register values in cooperative mode).</remarks>
 ///<param name="entry_point">Process entry point address.</param>
 ///<param name="stack_bottom">Address of stack bottom.</param>
 ///<returns>New bottom of the stack value.</returns>
@@ -234,6 +885,7 @@ uint8_t* prepare_process_context(atmos::process::entry_point_type entry_point, u
 	//Push the return address to process entry point.
 	stack_bottom = push_function_address(reinterpret_cast<const void*>(entry_point), stack_bottom);
 	
+#if ATMOS_PREEMPTIVE
 	//Push general purpose register values.
 	//First GPR - this will be R31 (see save_r31_and_sreg_from_scheduler, save_r31_and_sreg_from_task).
 	--stack_bottom;
@@ -241,6 +893,12 @@ uint8_t* prepare_process_context(atmos::process::entry_point_type entry_point, u
 	*--stack_bottom = _BV(ATMOS_AVR_INTERRUPT_BIT);
 	//Then go 31 more general purpose registers (or 15 for avrtiny architecture)
 	stack_bottom -= (atmos::process::gpr_size - 1);
+#else //ATMOS_PREEMPTIVE
+	//SREG goes first (see save_sreg_from_task): Interrupts are enabled by default.
+	*--stack_bottom = _BV(ATMOS_AVR_INTERRUPT_BIT);
+	//Then go call-saved general purpose registers (see save_call_saved_context).
+	stack_bottom -= atmos::process::gpr_size;
+#endif //ATMOS_PREEMPTIVE
 	return --stack_bottom;
 }
 
@@ -255,45 +913,169 @@ process_list_element* create_process(atmos::process::entry_point_type entry_poin
 	//Just prepare process context and control block.
 	auto* elem = reinterpret_cast<process_list_element*>(process_memory);
 	auto* stack_bottom = reinterpret_cast<uint8_t*>(process_memory) + memory_size;
+#if ATMOS_STACK_OVERFLOW_CHECK
+	*get_stack_canary(elem) = atmos::process::stack_canary_value;
+#endif //ATMOS_STACK_OVERFLOW_CHECK
 	elem->process.stack_pointer = static_cast<atmos::process::stack_pointer_type>(
 		reinterpret_cast<uint16_t>(prepare_process_context(entry_point, stack_bottom)));
 	return elem;
 }
 
+///<summary>Adds created process to the list of running processes.</summary>
+///<param name="process">Process returned by create_process.</param>
+///<returns>Process ID.</returns>
+atmos::process::id_type start_process(process_list_element* process) ATMOS_NONNULL(1);
+atmos::process::id_type start_process(process_list_element* process)
+{
+	atmos::kernel_lock lock;
+#if ATMOS_SUPPORT_SLEEP
+	insert_running_process(process);
+#else //ATMOS_SUPPORT_SLEEP
+	running_processes.push_front(process);
+#endif //ATMOS_SUPPORT_SLEEP
+	return to_pid(process);
+}
+
 } //namespace
 
+#if ATMOS_KERNEL_AWARE_ISR
+//Restores registers saved by ATMOS_ISR interrupt vector and atmos_interrupt_entry.
+#	define ATMOS_RESTORE_INTERRUPT_ENTRY_REGISTERS \
+		"pop r27                                    \n\t" \
+		"pop r26                                    \n\t" \
+		"pop r25                                    \n\t" \
+		"pop r24                                    \n\t" \
+		"pop r23                                    \n\t" \
+		"pop r22                                    \n\t" \
+		"pop r21                                    \n\t" \
+		"pop r20                                    \n\t" \
+		"pop r19                                    \n\t" \
+		"pop r18                                    \n\t" \
+		"pop r1                                     \n\t" \
+		"pop r0                                     \n\t" \
+		"out __SREG__, r0                           \n\t" \
+		"pop r0                                     \n\t" \
+		"pop r31                                    \n\t" \
+		"pop r30                                    \n\t"
+
+///<summary>Common part of ATMOS_ISR interrupt handlers. Saves call-used registers and SREG on process stack,
+///         then calls interrupt handler (on interrupt stack, if ATMOS_USE_INTERRUPT_STACK is enabled).
+///         If handler has woken up a process, switches context instead of returning to interrupted process
+///         (except for cooperative mode).</summary>
+///<remarks>Jumped to from ATMOS_ISR interrupt vector, which saves R30 and R31 and loads handler address to Z.</remarks>
+void ATMOS_NAKED ATMOS_USED atmos_interrupt_entry() asm("atmos_interrupt_entry");
+void atmos_interrupt_entry()
+{
+	__asm__ __volatile__ (
+		"push r0                                    \n\t"
+		"in r0, __SREG__                            \n\t"
+		"push r0                                    \n\t"
+		"push r1                                    \n\t"
+		"clr r1                                     \n\t"
+		"push r18                                   \n\t"
+		"push r19                                   \n\t"
+		"push r20                                   \n\t"
+		"push r21                                   \n\t"
+		"push r22                                   \n\t"
+		"push r23                                   \n\t"
+		"push r24                                   \n\t"
+		"push r25                                   \n\t"
+		"push r26                                   \n\t"
+		"push r27                                   \n\t"
+#	if ATMOS_SUPPORT_SLEEP && ATMOS_PREEMPTIVE
+		//Only processes woken up by the handler itself are switched to on handler exit.
+		//Processes woken up in process context are switched to by kernel_lock (if priorities are enabled)
+		//or by the scheduler.
+		"sts atmos_reschedule_requested, r1         \n\t"
+#	endif //ATMOS_SUPPORT_SLEEP && ATMOS_PREEMPTIVE
+#	if ATMOS_USE_INTERRUPT_STACK
+		//Save process stack pointer and switch to interrupt stack.
+		"in r24, __SP_L__                           \n\t"
+		"sts atmos_interrupted_stack_pointer, r24   \n\t"
+#		if !defined(__AVR_HAVE_8BIT_SP__) && !defined(__AVR_SP8__)
+		"in r24, __SP_H__                           \n\t"
+		"sts atmos_interrupted_stack_pointer+1, r24 \n\t"
+		"ldi r24, hi8(" STRINGIFY(RAMEND) ")        \n\t"
+		"out __SP_H__, r24                          \n\t"
+#		endif //16-bit stack
+		"ldi r24, lo8(" STRINGIFY(RAMEND) ")        \n\t"
+		"out __SP_L__, r24                          \n\t"
+#	endif //ATMOS_USE_INTERRUPT_STACK
+#	ifdef __AVR_HAVE_EIJMP_EICALL__
+		"eicall                                     \n\t"
+#	else //__AVR_HAVE_EIJMP_EICALL__
+		"icall                                      \n\t"
+#	endif //__AVR_HAVE_EIJMP_EICALL__
+#	if ATMOS_USE_INTERRUPT_STACK
+		//Switch back to process stack.
+#		if !defined(__AVR_HAVE_8BIT_SP__) && !defined(__AVR_SP8__)
+		"lds r24, atmos_interrupted_stack_pointer+1 \n\t"
+		"out __SP_H__, r24                          \n\t"
+#		endif //16-bit stack
+		"lds r24, atmos_interrupted_stack_pointer   \n\t"
+		"out __SP_L__, r24                          \n\t"
+#	endif //ATMOS_USE_INTERRUPT_STACK
+#	if ATMOS_SUPPORT_SLEEP && ATMOS_PREEMPTIVE
+		"lds r24, atmos_reschedule_requested        \n\t"
+		"tst r24                                    \n\t"
+		"brne 1f                                    \n\t"
+#	endif //ATMOS_SUPPORT_SLEEP && ATMOS_PREEMPTIVE
+		ATMOS_RESTORE_INTERRUPT_ENTRY_REGISTERS
+		"reti                                       \n\t"
+#	if ATMOS_SUPPORT_SLEEP && ATMOS_PREEMPTIVE
+		//Restore interrupted process registers, so that only return address is left on stack,
+		//and switch context like scheduler interrupt does, but without incrementing tick count.
+		"1:                                         \n\t"
+		ATMOS_RESTORE_INTERRUPT_ENTRY_REGISTERS
+		ATMOS_JUMP "atmos_reschedule_from_interrupt \n\t"
+#	endif //ATMOS_SUPPORT_SLEEP && ATMOS_PREEMPTIVE
+		::
+	);
+}
+#	undef ATMOS_RESTORE_INTERRUPT_ENTRY_REGISTERS
+#endif //ATMOS_KERNEL_AWARE_ISR
+
+#if ATMOS_PREEMPTIVE
 //Scheduler interrupt. Saves current process context and then switches context to next process.
 ISR(ATMOS_TIMER_INTERRUPT_NAME, ISR_NAKED ATMOS_HOT)
 {
 	save_r31_and_sreg_from_scheduler();
 	
-#if ATMOS_SUPPORT_SLEEP
+#	if ATMOS_SUPPORT_SLEEP
 	__asm__ __volatile__ (
 		"set \n\t"
 		::
 	);
-#endif //ATMOS_SUPPORT_SLEEP
+#	endif //ATMOS_SUPPORT_SLEEP
 
 	save_context_and_switch_to_next_process_context();
 }
+#endif //ATMOS_PREEMPTIVE
 
 namespace atmos
 {
 
+#if ATMOS_SUPPORT_PRIORITIES && ATMOS_PREEMPTIVE
+volatile bool detail::preemption_requested = false;
+#endif //ATMOS_SUPPORT_PRIORITIES && ATMOS_PREEMPTIVE
+
 void kernel::run()
 {
 #if ATMOS_ENABLE_SYSTEM_PROCESS
-	static atmos::process_memory_block<0> system_process_memory;
+	static atmos::process_memory_block<system_process_stack_size> system_process_memory;
 	system_process = create_process(system_process_entry_point, system_process_memory.get_memory(),
 		decltype(system_process_memory)::memory_block_size);
 #endif //ATMOS_ENABLE_SYSTEM_PROCESS
 	
+#if ATMOS_PREEMPTIVE || ATMOS_SUPPORT_SLEEP
 	initialize_scheduler_timer();
+#endif //ATMOS_PREEMPTIVE || ATMOS_SUPPORT_SLEEP
 	//Run kernel: switch to first available process and run it.
 	__asm__ __volatile__ (
-#if ATMOS_SUPPORT_SLEEP
+#if ATMOS_SCHEDULER_TICK_FLAG
 		"clt                                        \n\t"
-#endif //ATMOS_SUPPORT_SLEEP
+		"clr r22                                    \n\t"
+#endif //ATMOS_SCHEDULER_TICK_FLAG
 		ATMOS_CALL "save_sp_and_choose_next_process \n\t"
 		ATMOS_JUMP "switch_to_stack                 \n\t"
 		::
@@ -301,34 +1083,158 @@ void kernel::run()
 	__builtin_unreachable();
 }
 
+#if ATMOS_STACK_OVERFLOW_CHECK
+void ATMOS_WEAK kernel::stack_overflow_hook(process::id_type)
+{
+	cli();
+	while(true)
+	{
+	}
+}
+#endif //ATMOS_STACK_OVERFLOW_CHECK
+
+#if ATMOS_SUPPORT_IDLE_HOOK
+void ATMOS_WEAK kernel::idle_hook()
+{
+}
+#endif //ATMOS_SUPPORT_IDLE_HOOK
+
+#if ATMOS_SUPPORT_SLEEP
+process::tick_t kernel::get_tick_count()
+{
+	atmos::kernel_lock lock;
+#	if !ATMOS_PREEMPTIVE
+	advance_tick_count();
+#	endif //!ATMOS_PREEMPTIVE
+	return tick_counter;
+}
+#endif //ATMOS_SUPPORT_SLEEP
+
+#if ATMOS_SUPPORT_STATISTICS
+kernel::statistics kernel::stats()
+{
+	atmos::kernel_lock lock;
+	return ::statistics;
+}
+
+void kernel::reset_stats()
+{
+	atmos::kernel_lock lock;
+	::statistics = statistics{};
+}
+
+uint16_t kernel::get_run_count(process::id_type pid)
+{
+	atmos::kernel_lock lock;
+	return from_pid(pid)->process.run_count;
+}
+#endif //ATMOS_SUPPORT_STATISTICS
+
+#if ATMOS_SUPPORT_CPU_LOAD
+uint8_t kernel::cpu_load()
+{
+	uint32_t idle;
+	uint16_t top;
+	{
+		atmos::kernel_lock lock;
+		if(!cpu_load_measured)
+			return 0;
+		
+		idle = smoothed_idle_counts;
+		top = get_scheduler_timer_top();
+	}
+	
+	uint32_t counts_per_percent = (static_cast<uint32_t>(top) + 1) * ATMOS_CPU_LOAD_WINDOW_TICKS / 100;
+	if(!counts_per_percent)
+		counts_per_percent = 1;
+	
+	uint32_t idle_percent = idle / counts_per_percent;
+	return idle_percent >= 100 ? 0 : static_cast<uint8_t>(100 - idle_percent);
+}
+#endif //ATMOS_SUPPORT_CPU_LOAD
+
+#if ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+void kernel::set_tick_period_us(uint32_t tick_period_us, uint8_t prescaler_control_value, uint16_t top_value)
+{
+	atmos::kernel_lock lock;
+#	if ATMOS_SUPPORT_SLEEP
+	rescale_sleeping_processes(::tick_period_us, tick_period_us);
+#	endif //ATMOS_SUPPORT_SLEEP
+	::tick_period_us = tick_period_us;
+	reconfigure_scheduler_timer(prescaler_control_value, top_value);
+}
+
+uint32_t detail::get_tick_period_us()
+{
+	atmos::kernel_lock lock;
+	return ::tick_period_us;
+}
+#endif //ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+
 //Creates new process.
 process::id_type process::create(process::entry_point_type entry_point,
 	process::stack_pointer_type process_memory, size_t memory_size)
 {
 	//Prepare process stack and context.
-	auto* process = create_process(entry_point, process_memory, memory_size);
-	
+	return start_process(create_process(entry_point, process_memory, memory_size));
+}
+
+#if ATMOS_SUPPORT_PROCESS_DESCRIPTORS
+process::id_type process::create(const process_descriptor* descriptor)
+{
+	auto entry_point = reinterpret_cast<entry_point_type>(pgm_read_ptr(&descriptor->entry_point));
+	auto process_memory = static_cast<stack_pointer_type>(
+		reinterpret_cast<uint16_t>(pgm_read_ptr(&descriptor->memory)));
+	auto* process = create_process(entry_point, process_memory, pgm_read_word(&descriptor->memory_size));
+#	if ATMOS_SUPPORT_PRIORITIES
+	process->process.priority = pgm_read_byte(&descriptor->priority);
+#	endif //ATMOS_SUPPORT_PRIORITIES
+	return start_process(process);
+}
+
+void process::create_all(const process_descriptor* table, uint8_t count)
+{
+	process_table = table;
+	process_table_size = count;
+	for(uint8_t i = 0; i != count; ++i)
+		create(table + i);
+}
+
+const process_descriptor* process::get_descriptor(id_type pid)
+{
+	for(uint8_t i = 0; i != process_table_size; ++i)
 	{
-		//Add new process to the list of running processes.
-		atmos::kernel_lock lock;
-		running_processes.push_front(process);
+		auto* descriptor = process_table + i;
+		if(reinterpret_cast<uint16_t>(pgm_read_ptr(&descriptor->memory)) == pid)
+			return descriptor;
 	}
 	
-	//Return process ID.
-	return to_pid(process);
+	return nullptr;
+}
+
+const char* process::get_name(id_type pid)
+{
+	auto* descriptor = get_descriptor(pid);
+	return descriptor ? static_cast<const char*>(pgm_read_ptr(&descriptor->name)) : nullptr;
 }
+#endif //ATMOS_SUPPORT_PROCESS_DESCRIPTORS
 
 #if ATMOS_SUPPORT_SLEEP || ATMOS_SUPPORT_YIELD
 void process::yield()
 {
+#	if ATMOS_PREEMPTIVE
 	save_r31_and_sreg_from_task();
 
-#	if ATMOS_SUPPORT_SLEEP
+#		if ATMOS_SUPPORT_SLEEP
 	__asm__ __volatile__ (
 		"clt \n\t"
 		::
 	);
-#	endif //ATMOS_SUPPORT_SLEEP
+#		endif //ATMOS_SUPPORT_SLEEP
+#	else //ATMOS_PREEMPTIVE
+	//Process calls yield as a regular function, so only call-saved registers and SREG are saved.
+	save_sreg_from_task();
+#	endif //ATMOS_PREEMPTIVE
 	
 	save_context_and_switch_to_next_process_context();
 }
@@ -344,19 +1250,186 @@ void process::sleep_ticks(tick_t ticks)
 	}
 	
 	atmos::kernel_lock lock;
-	
-	tick_t sleep_until = tick_counter + ticks;
-	(*current_process)->process.sleep_until = sleep_until;
 	running_processes.remove(current_process);
+	put_process_to_sleep(current_process, ticks);
+#	if ATMOS_SUPPORT_STATISTICS
+	switch_reason = kernel::switch_reason::sleep;
+#	endif //ATMOS_SUPPORT_STATISTICS
+	yield();
+}
+
+void process::sleep_until(chrono::time_point wake_up_time)
+{
+	atmos::kernel_lock lock;
+#	if !ATMOS_PREEMPTIVE
+	advance_tick_count();
+#	endif //!ATMOS_PREEMPTIVE
+	auto ticks = static_cast<tick_t>(wake_up_time.tick_count() - tick_counter);
+	//Tick counter wraps around, so time point which is more than half of tick counter range ahead
+	//has already passed (for example, when periodic process has overrun its period).
+	if(ticks > static_cast<tick_t>(~tick_t{}) / 2u)
+		ticks = 0;
 	
-	auto& target_list = sleep_until < ticks ? waiting_processes_overflown : waiting_processes;
-	target_list.insert_before(current_process, [sleep_until](const auto* before)
-	{
-		return before->process.sleep_until > sleep_until;
-	});
+	sleep_ticks(ticks);
+}
+
+void wait_list::wait()
+{
+	auto* current = current_process;
+	running_processes.remove(current);
+	(*current)->process.list = process::process_list_type::none;
+	//Append process to the end of list to wake up processes in FIFO order.
+	waiters_.push_back(static_cast<process_list_element*>(current));
+#	if ATMOS_SUPPORT_STATISTICS
+	switch_reason = kernel::switch_reason::sleep;
+#	endif //ATMOS_SUPPORT_STATISTICS
+	
+	process::yield();
+}
+
+bool wait_list::wait_for(process::tick_t ticks)
+{
+	if(!ticks)
+		return false;
+	
+	auto* current = current_process;
+	auto* waiter = static_cast<process_list_element*>(current);
+	running_processes.remove(current);
+	waiters_.push_back(waiter);
+	waiter->process.timed_wait = process::timed_wait_state::waiting;
+	put_process_to_sleep(current, ticks);
+#	if ATMOS_SUPPORT_STATISTICS
+	switch_reason = kernel::switch_reason::sleep;
+#	endif //ATMOS_SUPPORT_STATISTICS
+	
+	process::yield();
+	
+	auto timed_wait = waiter->process.timed_wait;
+	waiter->process.timed_wait = process::timed_wait_state::none;
+	if(timed_wait == process::timed_wait_state::notified)
+		return true;
+	
+	//Process was woken up by scheduler tick, so it is still contained in the wait list.
+	waiters_.remove(waiter);
+	return false;
+}
+
+bool process::yield_to(id_type pid)
+{
+	process_list_element_tagged* target = from_pid(pid);
+	atmos::kernel_lock lock;
+	auto* current = current_process;
+#	if ATMOS_SUPPORT_PRIORITIES
+	//Target process can be inserted after current process only if this keeps priority order.
+	//Scheduler runs the highest priority running process anyway, so there is no hand-off otherwise
+	//(higher priority process may be running, if current process has preemption threshold).
+	auto priority = (*current)->process.priority;
+	bool running = target != current && (*target)->process.priority == priority
+		&& (*running_processes.first())->process.priority == priority && remove_running_process(target);
+#	else //ATMOS_SUPPORT_PRIORITIES
+	bool running = target != current && remove_running_process(target);
+#	endif //ATMOS_SUPPORT_PRIORITIES
+	if(running)
+		insert_next_running_process(current, target);
 	
 	yield();
+	return running;
+}
+
+#	if ATMOS_SUPPORT_SUSPEND
+void process::suspend(id_type pid)
+{
+	process_list_element_tagged* process = from_pid(pid);
+	atmos::kernel_lock lock;
+	if((*process)->process.suspended)
+		return;
+	
+	(*process)->process.suspended = true;
+	//Sleeping or waiting process is moved to the list of suspended processes when woken up.
+	if(!remove_running_process(process))
+		return;
+	
+	insert_suspended_process(process);
+	if(process == current_process)
+	{
+#		if ATMOS_SUPPORT_STATISTICS
+		switch_reason = kernel::switch_reason::sleep;
+#		endif //ATMOS_SUPPORT_STATISTICS
+		yield();
+	}
+}
+
+void process::resume(id_type pid)
+{
+	process_list_element_tagged* process = from_pid(pid);
+	atmos::kernel_lock lock;
+	(*process)->process.suspended = false;
+	//Sleeping or waiting process is moved to the list of running processes when woken up.
+	if((*process)->process.list == process_list_type::suspended)
+	{
+		suspended_processes.remove(process);
+		wake_up_process(process);
+	}
+}
+#	endif //ATMOS_SUPPORT_SUSPEND
+
+#	if ATMOS_SUPPORT_PRIORITIES
+void process::set_priority(id_type pid, priority_type priority)
+{
+	process_list_element_tagged* process = from_pid(pid);
+	atmos::kernel_lock lock;
+	(*process)->process.priority = priority;
+	if(remove_running_process(process))
+	{
+		insert_running_process(process);
+		reschedule_requested = true;
+#		if ATMOS_PREEMPTIVE
+		check_preemption();
+#		endif //ATMOS_PREEMPTIVE
+	}
+}
+
+process::priority_type process::get_priority(id_type pid)
+{
+	return from_pid(pid)->process.priority;
+}
+#	endif //ATMOS_SUPPORT_PRIORITIES
+
+#	if ATMOS_SUPPORT_PREEMPTION_THRESHOLD
+void process::set_preemption_threshold(id_type pid, priority_type threshold)
+{
+	atmos::kernel_lock lock;
+	from_pid(pid)->process.preemption_threshold = threshold;
+	//Higher priority process may be already waiting for preemption.
+	reschedule_requested = true;
+	check_preemption();
+}
+
+process::priority_type process::get_preemption_threshold(id_type pid)
+{
+	return from_pid(pid)->process.preemption_threshold;
+}
+#	endif //ATMOS_SUPPORT_PREEMPTION_THRESHOLD
+
+bool wait_list::notify_one()
+{
+	atmos::kernel_lock lock;
+	auto* waiter = waiters_.pop_front();
+	if(!waiter)
+		return false;
+	
+	wake_up_waiter(static_cast<process_list_element*>(waiter));
+	return true;
+}
+
+void wait_list::notify_all()
+{
+	atmos::kernel_lock lock;
+	while(auto* waiter = waiters_.pop_front())
+		wake_up_waiter(static_cast<process_list_element*>(waiter));
 }
 #endif //ATMOS_SUPPORT_SLEEP
 
 } //namespace atmos
+
+#endif //!ATMOS_SINGLE_STACK_MODE
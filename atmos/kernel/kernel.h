@@ -1,8 +1,15 @@
 #pragma once
 
+#include "chrono.h"
+#include "config.h"
 #include "defines.h"
+#include "process.h"
 #include "static_class.h"
 
+#if ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+#	include "scheduler_timer_setup.h"
+#endif //ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+
 namespace atmos
 {
 
@@ -12,6 +19,124 @@ class kernel final : public static_class
 public:
 	///<summary>Runs ATMOS. Does not return.</summary>
 	static void ATMOS_NORETURN run();
+	
+#if ATMOS_SUPPORT_SLEEP
+	///<summary>Returns current scheduler tick count.</summary>
+	///<remarks>Tick counter overflows, use difference of two tick counts to measure time intervals.</remarks>
+	///<returns>Number of scheduler ticks passed since kernel start.</returns>
+	static process::tick_t get_tick_count();
+	
+	///<summary>Returns current time point.</summary>
+	///<returns>Time point of current scheduler tick.</returns>
+	static chrono::time_point now()
+	{
+		return chrono::time_point(get_tick_count());
+	}
+#endif //ATMOS_SUPPORT_SLEEP
+
+#if ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+	///<summary>Changes scheduler tick period. Current tick is restarted with the new period,
+	///         and wake up times of sleeping processes are rescaled to the new tick period
+	///         (rounded up, so processes never wake up earlier).</summary>
+	///<remarks>Timer prescaler and top values are calculated at compile time.</remarks>
+	///<typeparam name="TickPeriodUs">New tick period in microseconds.</typeparam>
+	template<uint32_t TickPeriodUs>
+	static void set_tick_period_us()
+	{
+		constexpr auto params = detail::calculate_scheduler_timer_params(TickPeriodUs);
+		static_assert(params.top_value, "Unable to deduce timer prescaler and limiting values for tick period");
+		set_tick_period_us(TickPeriodUs, params.prescaler_control_value, params.top_value);
+	}
+	
+	///<summary>Returns current scheduler tick period.</summary>
+	///<returns>Tick period in microseconds.</returns>
+	static uint32_t get_tick_period_us()
+	{
+		return detail::get_tick_period_us();
+	}
+#endif //ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+
+#if ATMOS_SUPPORT_STATISTICS
+	///Context switch reasons.
+	enum class switch_reason : uint8_t
+	{
+		///Scheduler tick switched to the next running process.
+		tick,
+		///Process yielded execution (see process::yield).
+		yield,
+		///Process went to sleep or was blocked on wait list.
+		sleep,
+		///ATMOS_ISR interrupt handler woke up process (see interrupt.h).
+		interrupt
+	};
+	
+	///Number of context switch reasons.
+	static constexpr uint8_t switch_reason_count = 4;
+	
+	///Kernel statistics. Counters and histogram buckets wrap around.
+	struct statistics
+	{
+		///Number of context switches to a different process, indexed by switch_reason.
+		uint32_t context_switches[switch_reason_count];
+		///Maximal scheduler interrupt duration, measured by scheduler timer counter from timer compare match
+		///to next process selection. Multiply by scheduler timer prescaler to get CPU cycles.
+		uint16_t max_scheduler_duration;
+		///Histogram of scheduler interrupt durations in timer counts. Bucket 0 counts zero durations,
+		///bucket N counts durations from 2^(N-1) to 2^N-1, and the last bucket also counts all longer durations.
+		uint16_t scheduler_duration_histogram[ATMOS_STATISTICS_HISTOGRAM_SIZE];
+		///Maximal delay in ticks between sleep (or wait timeout) expiry and process dispatch.
+		process::tick_t max_wake_up_delay;
+		///Histogram of wake up delays. Bucket N counts delays of N ticks, and the last bucket
+		///also counts all longer delays.
+		uint16_t wake_up_delay_histogram[ATMOS_STATISTICS_HISTOGRAM_SIZE];
+	};
+	
+	///<summary>Returns kernel statistics collected since kernel start or last reset_stats() call.</summary>
+	///<returns>Copy of kernel statistics.</returns>
+	static statistics stats();
+	
+	///<summary>Resets kernel statistics, except per-process run counts.</summary>
+	static void reset_stats();
+	
+	///<summary>Returns number of times process was switched to.</summary>
+	///<param name="pid">Process ID.</param>
+	///<returns>Process run count (wraps around).</returns>
+	static uint16_t get_run_count(process::id_type pid);
+#endif //ATMOS_SUPPORT_STATISTICS
+
+#if ATMOS_SUPPORT_CPU_LOAD
+	///<summary>Returns CPU load, which is the share of time not spent in system process.</summary>
+	///<remarks>Idle time is measured in scheduler timer counts and averaged over ATMOS_CPU_LOAD_WINDOW_TICKS ticks.
+	///Each window result is exponentially smoothed with weight 1/4.</remarks>
+	///<returns>CPU load in percent (0 to 100). Returns 0 until the first measurement window is completed.</returns>
+	static uint8_t cpu_load();
+#endif //ATMOS_SUPPORT_CPU_LOAD
+
+#if ATMOS_SUPPORT_IDLE_HOOK
+	///<summary>Called in a loop by system process, when there are no other processes to run.</summary>
+	///<remarks>Default implementation does nothing. Can be redefined by user, for example, to put MCU into
+	///sleep mode until the next interrupt (see avr/sleep.h). Selected sleep mode must keep scheduler timer running.
+	///Runs on system process stack (see ATMOS_SYSTEM_PROCESS_STACK_SIZE) with interrupts enabled,
+	///must not block, sleep or wait.</remarks>
+	static void idle_hook();
+#endif //ATMOS_SUPPORT_IDLE_HOOK
+
+#if ATMOS_STACK_OVERFLOW_CHECK
+	///<summary>Called with interrupts disabled when process stack overflow is detected.</summary>
+	///<remarks>Default implementation halts the system. Can be redefined by user,
+	///must not return, as process stack and control block may be corrupted.</remarks>
+	///<param name="pid">ID of process which stack has overflown.</param>
+	static void ATMOS_NORETURN stack_overflow_hook(process::id_type pid);
+#endif //ATMOS_STACK_OVERFLOW_CHECK
+
+#if ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+private:
+	///<summary>Changes scheduler tick period (see set_tick_period_us template).</summary>
+	///<param name="tick_period_us">New tick period in microseconds.</param>
+	///<param name="prescaler_control_value">Combination of timer prescaler control bits.</param>
+	///<param name="top_value">Timer CTC compare register value.</param>
+	static void set_tick_period_us(uint32_t tick_period_us, uint8_t prescaler_control_value, uint16_t top_value);
+#endif //ATMOS_SUPPORT_TICK_PERIOD_CHANGE
 };
 
 } //namespace atmos
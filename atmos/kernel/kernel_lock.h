@@ -5,12 +5,29 @@
 #include <avr/interrupt.h>
 #include <avr/io.h>
 
+#include "config.h"
 #include "noncopyable.h"
 
+#if ATMOS_SUPPORT_PRIORITIES && ATMOS_PREEMPTIVE
+#	include "context_switch.h"
+#	include "process.h"
+#endif //ATMOS_SUPPORT_PRIORITIES && ATMOS_PREEMPTIVE
+
 namespace atmos
 {
 
+#if ATMOS_SUPPORT_PRIORITIES && ATMOS_PREEMPTIVE
+namespace detail
+{
+///Set when running process with priority above current process priority appears (process is woken up
+///or its priority is changed). Cleared on each context switch.
+extern volatile bool preemption_requested;
+} //namespace detail
+#endif //ATMOS_SUPPORT_PRIORITIES && ATMOS_PREEMPTIVE
+
 ///Disables all interrupts in constructor, restores in destructor.
+///If priorities are enabled, destructor which enables interrupts (that is, releases the outermost lock
+///in process context) switches to higher priority process woken up under the lock right away.
 class kernel_lock : public nonmovable
 {
 public:
@@ -22,6 +39,12 @@ public:
 	
 	~kernel_lock()
 	{
+#if ATMOS_SUPPORT_PRIORITIES && ATMOS_PREEMPTIVE
+		//Interrupt handlers must not enable interrupts, so lock is released in process context here.
+		if((prev_sreg_ & _BV(ATMOS_AVR_INTERRUPT_BIT)) && detail::preemption_requested)
+			process::yield();
+#endif //ATMOS_SUPPORT_PRIORITIES && ATMOS_PREEMPTIVE
+		
 		SREG = prev_sreg_;
 	}
 	
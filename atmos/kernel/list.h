@@ -0,0 +1,339 @@
+#pragma once
+
+#include "defines.h"
+
+namespace atmos
+{
+namespace container
+{
+
+///Base class for strongly typed element of doubly-linked list.
+///Can be contained in single list only.
+struct ATMOS_PACKED list_element
+{
+	///Next list item or nullptr.
+	list_element* next = nullptr;
+	///Previous list item, or last list item, if element is the first one.
+	list_element* prev = nullptr;
+};
+
+///Base class for strongly typed doubly-linked list. Unlike forward_list_base, element is removed
+///and appended in O(1) time. Pointer to the last element is stored in the first element instead of
+///list object, so list object can be copied or swapped with another list like forward_list_base.
+struct ATMOS_PACKED list_base
+{
+	///Pointer to first list element or nullptr if list is empty.
+	list_element* first_element = nullptr;
+
+	///<summary>Push new element to front of list.</summary>
+	///<param name="elem">Element not attached to any list. Can not be nullptr.</param>
+	void push_front(list_element* elem) ATMOS_NONNULL(1);
+
+	///<summary>Push new element to back of list.</summary>
+	///<remarks>Has O(1) time complexity.</remarks>
+	///<param name="elem">Element not attached to any list. Can not be nullptr.</param>
+	void push_back(list_element* elem) ATMOS_NONNULL(1);
+
+	///<summary>Pop front element of list.</summary>
+	///<returns>Front list element or nullptr if list is empty.</returns>
+	list_element* pop_front();
+
+	///<summary>Remove element from list.</summary>
+	///<remarks>Has O(1) time complexity.</remarks>
+	///<param name="elem">Element of this list. Can not be nullptr.</param>
+	void remove(list_element* elem) ATMOS_NONNULL(1);
+
+	///<summary>Insert element "elem" before element "current".</summary>
+	///<param name="prev">Element which is before "current" element. Can be nullptr.</param>
+	///<param name="current">Element after which "elem" element must be inserted. Can be nullptr.</param>
+	///<param name="elem">Element not attached to any list. Can not be nullptr.</param>
+	void insert_before(list_element* prev, list_element* current, list_element* elem) ATMOS_NONNULL(3);
+
+	///<summary>Insert element "elem" after element "pos".</summary>
+	///<param name="pos">Element of this list. Can not be nullptr.</param>
+	///<param name="elem">Element not attached to any list. Can not be nullptr.</param>
+	void insert_after(list_element* pos, list_element* elem) ATMOS_NONNULL(1, 2);
+
+	///<summary>Move front elements of another list to front of this list.</summary>
+	///<param name="other">List to move elements from.</param>
+	///<param name="last">Last element of "other" list to move. All elements before it are moved too. Can not be nullptr.</param>
+	void splice_front(list_base& other, list_element* last) ATMOS_NONNULL(2);
+
+	///<summary>Returns true if element is contained in list.</summary>
+	///<remarks>Has O(n) time complexity.</remarks>
+	///<param name="elem">Any element of any list.</param>
+	///<returns>True if element is contained in list.</returns>
+	bool contains(const list_element* elem) const;
+
+	///<summary>Returns true if list is empty.</summary>
+	///<returns>True if list is empty, false otherwise.</returns>
+	bool empty() const;
+
+	///<summary>Returns first element of the list or nullptr if list is empty.</summary>
+	///<returns>First element of the list or nullptr if list is empty.</returns>
+	list_element* first();
+};
+
+inline void list_base::push_front(list_element* elem)
+{
+	insert_before(nullptr, first_element, elem);
+}
+
+inline void list_base::push_back(list_element* elem)
+{
+	if(first_element)
+		insert_after(first_element->prev, elem);
+	else
+		push_front(elem);
+}
+
+inline list_element* list_base::pop_front()
+{
+	auto* result = first_element;
+	if(result)
+		remove(result);
+	return result;
+}
+
+inline void list_base::remove(list_element* elem)
+{
+	auto* next = elem->next;
+	auto* prev = elem->prev;
+	if(elem == first_element)
+		first_element = next;
+	else
+		prev->next = next;
+
+	//Previous element of the first element is the last element.
+	if(next)
+		next->prev = prev;
+	else if(first_element)
+		first_element->prev = prev;
+
+	elem->next = nullptr;
+	elem->prev = nullptr;
+}
+
+inline void list_base::insert_before(list_element* prev, list_element* current, list_element* elem)
+{
+	elem->next = current;
+	if(prev)
+	{
+		elem->prev = prev;
+		prev->next = elem;
+	}
+	else
+	{
+		//Element becomes the first one, so it keeps pointer to the last element.
+		elem->prev = current ? current->prev : elem;
+		first_element = elem;
+	}
+
+	if(current)
+		current->prev = elem;
+	else
+		first_element->prev = elem;
+}
+
+inline void list_base::insert_after(list_element* pos, list_element* elem)
+{
+	insert_before(pos, pos->next, elem);
+}
+
+inline void list_base::splice_front(list_base& other, list_element* last)
+{
+	auto* first = other.first_element;
+	auto* rest = last->next;
+	other.first_element = rest;
+	if(rest)
+		rest->prev = first->prev;
+
+	last->next = first_element;
+	if(first_element)
+	{
+		first->prev = first_element->prev;
+		first_element->prev = last;
+	}
+	else
+	{
+		first->prev = last;
+	}
+
+	first_element = first;
+}
+
+inline bool list_base::contains(const list_element* elem) const
+{
+	for(auto* current = first_element; current; current = current->next)
+	{
+		if(current == elem)
+			return true;
+	}
+
+	return false;
+}
+
+inline bool list_base::empty() const
+{
+	return !first_element;
+}
+
+inline list_element* list_base::first()
+{
+	return first_element;
+}
+
+///Base class for typed element of doubly-linked list. Supports tags, allowing element to be in several different
+///doubly-linked lists simultaneously.
+template<typename Tag, typename ContainedType>
+struct ATMOS_PACKED list_element_tagged : list_element
+{
+	using tag_type = Tag;
+	using contained_type = ContainedType;
+	using list_element_type = list_element_tagged<tag_type, contained_type>;
+
+	///<summary>Downcasts list element to contained element type.</summary>
+	///<returns>Contained element pointer.</returns>
+	contained_type* operator->()
+	{
+		return static_cast<contained_type*>(this);
+	}
+};
+
+///Typed doubly-linked list which allows its typed contained elements to be contained in several different lists.
+///Has the same interface as forward_list_tagged, except for O(1) remove() and push_back(),
+///and absence of set_next() and set_first().
+template<typename ListElement>
+struct ATMOS_PACKED list_tagged : private list_base
+{
+	using list_element_type = ListElement;
+	using tag_type = typename list_element_type::tag_type;
+	using contained_type = typename list_element_type::contained_type;
+
+	using list_base::empty;
+	using list_base::contains;
+
+	///<summary>Push new element to front of list.</summary>
+	///<param name="elem">Element not attached to any list of the same type. Can not be nullptr.</param>
+	void push_front(list_element_type* elem) ATMOS_NONNULL(1);
+
+	///<summary>Push new element to back of list.</summary>
+	///<remarks>Has O(1) time complexity.</remarks>
+	///<param name="elem">Element not attached to any list of the same type. Can not be nullptr.</param>
+	void push_back(list_element_type* elem) ATMOS_NONNULL(1);
+
+	///<summary>Pop front element of list.</summary>
+	///<returns>Front list element or nullptr if list is empty.</returns>
+	list_element_type* pop_front();
+
+	///<summary>Remove element from list.</summary>
+	///<remarks>Has O(1) time complexity.</remarks>
+	///<param name="elem">Element of this list. Can not be nullptr.</param>
+	void remove(list_element_type* elem) ATMOS_NONNULL(1);
+
+	///<summary>Returns first element of the list or nullptr if list is empty.</summary>
+	///<returns>First element of the list or nullptr if list is empty.</returns>
+	list_element_type* first();
+
+	///<summary>Insert element "elem" before any element that satisfies the condition.</summary>
+	///<remarks>If list is empty, element "elem" is just inserted.</remarks>
+	///<param name="elem">Element not attached to any list of the same type. Can not be nullptr.</param>
+	///<param name="compare">Functor "compare" should return true, if the element satisfies the condition, and false otherwise.
+	///                      This functor is called for each element of a list.</param>
+	template<typename Func>
+	void insert_before(list_element_type* elem, Func&& compare) ATMOS_NONNULL(1);
+
+	///<summary>Insert element "elem" after element "pos".</summary>
+	///<param name="pos">Element of this list. Can not be nullptr.</param>
+	///<param name="elem">Element not attached to any list of the same type. Can not be nullptr.</param>
+	void insert_after(list_element_type* pos, list_element_type* elem) ATMOS_NONNULL(1, 2);
+
+	///<summary>Move front elements of another list to front of this list.</summary>
+	///<param name="other">List to move elements from.</param>
+	///<param name="last">Last element of "other" list to move. All elements before it are moved too. Can not be nullptr.</param>
+	void splice_front(list_tagged& other, list_element_type* last) ATMOS_NONNULL(2);
+
+	///<summary>Returns element after "elem" element.</summary>
+	///<param name="elem">Any element of any list. Can not be nullptr.</param>
+	///<returns>Element after "elem" element or nullptr if there is no element.</returns>
+	static list_element_type* next(list_element_type* elem) ATMOS_NONNULL(1);
+
+	///<summary>Returns element before "elem" element.</summary>
+	///<param name="elem">Any element of any list. Can not be nullptr.</param>
+	///<returns>Element before "elem" element, or the last element of the list if "elem" is the first element.</returns>
+	static list_element_type* prev(list_element_type* elem) ATMOS_NONNULL(1);
+};
+
+template<typename ListElement>
+void list_tagged<ListElement>::push_front(list_element_type* elem)
+{
+	list_base::push_front(elem);
+}
+
+template<typename ListElement>
+void list_tagged<ListElement>::push_back(list_element_type* elem)
+{
+	list_base::push_back(elem);
+}
+
+template<typename ListElement>
+typename list_tagged<ListElement>::list_element_type* list_tagged<ListElement>::pop_front()
+{
+	return static_cast<list_element_type*>(list_base::pop_front());
+}
+
+template<typename ListElement>
+void list_tagged<ListElement>::remove(list_element_type* elem)
+{
+	list_base::remove(elem);
+}
+
+template<typename ListElement>
+typename list_tagged<ListElement>::list_element_type* list_tagged<ListElement>::first()
+{
+	return static_cast<list_element_type*>(first_element);
+}
+
+template<typename ListElement>
+template<typename Func>
+void list_tagged<ListElement>::insert_before(list_element_type* elem, Func&& compare)
+{
+	list_element* current = first_element;
+	list_element* prev = nullptr;
+	while(current)
+	{
+		if(compare(static_cast<contained_type*>(static_cast<list_element_type*>(current))))
+			break;
+
+		prev = current;
+		current = current->next;
+	}
+
+	return list_base::insert_before(prev, current, elem);
+}
+
+template<typename ListElement>
+void list_tagged<ListElement>::insert_after(list_element_type* pos, list_element_type* elem)
+{
+	list_base::insert_after(pos, elem);
+}
+
+template<typename ListElement>
+void list_tagged<ListElement>::splice_front(list_tagged& other, list_element_type* last)
+{
+	list_base::splice_front(other, last);
+}
+
+template<typename ListElement>
+typename list_tagged<ListElement>::list_element_type* list_tagged<ListElement>::next(list_element_type* elem)
+{
+	return static_cast<list_element_type*>(elem->next);
+}
+
+template<typename ListElement>
+typename list_tagged<ListElement>::list_element_type* list_tagged<ListElement>::prev(list_element_type* elem)
+{
+	return static_cast<list_element_type*>(elem->prev);
+}
+} //namespace container
+} //namespace atmos
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "config.h"
+
+#if ATMOS_SUPPORT_SLEEP
+
+#include "defines.h"
+#include "forward_list.h"
+#include "kernel_lock.h"
+#include "noncopyable.h"
+#include "process.h"
+#include "wait_list.h"
+
+namespace atmos
+{
+
+struct message_list_tag;
+
+///Base class for messages passed through mailbox. Contains intrusive list link,
+///so messages are queued without copying and without mailbox capacity limit.
+///Message is owned by a single process at a time: sending message lends it to receiver.
+struct ATMOS_PACKED message : container::forward_list_element_tagged<message_list_tag, message>
+{
+};
+
+///Pool of pre-allocated message buffers.
+///<typeparam name="Message">Message type. Must be derived from message.</typeparam>
+///<typeparam name="Count">Number of messages in pool.</typeparam>
+template<typename Message, uint8_t Count>
+class message_pool : public nonmovable
+{
+	static_assert(Count > 0, "Message pool must not be empty");
+
+public:
+	///Creates message pool. All messages are free.
+	message_pool()
+	{
+		for(auto& msg : messages_)
+			free_.push_front(&msg);
+	}
+
+	///<summary>Allocates message buffer. Blocks current process while there are no free buffers.</summary>
+	///<returns>Allocated message.</returns>
+	Message* allocate()
+	{
+		atmos::kernel_lock lock;
+		waiters_.wait([this] { return !free_.empty(); });
+		return pop();
+	}
+
+	///<summary>Allocates message buffer. Blocks current process while there are no free buffers,
+	///         but not longer than timeout.</summary>
+	///<param name="ticks">Timeout in scheduler ticks.</param>
+	///<returns>Allocated message or nullptr if timeout expired.</returns>
+	Message* allocate_for(process::tick_t ticks)
+	{
+		atmos::kernel_lock lock;
+		if(!waiters_.wait_for(ticks, [this] { return !free_.empty(); }))
+			return nullptr;
+
+		return pop();
+	}
+
+	///<summary>Allocates message buffer, if there is any free one.</summary>
+	///<remarks>Can be called from ISR.</remarks>
+	///<returns>Allocated message or nullptr if there are no free buffers.</returns>
+	Message* try_allocate()
+	{
+		atmos::kernel_lock lock;
+		return pop();
+	}
+
+	///<summary>Returns message buffer to the pool and wakes up process waiting for free buffer.</summary>
+	///<remarks>Can be called from ISR.</remarks>
+	///<param name="msg">Message allocated from this pool. Can not be nullptr.</param>
+	void release(Message* msg) ATMOS_NONNULL(2)
+	{
+		atmos::kernel_lock lock;
+		free_.push_front(msg);
+		waiters_.notify_one();
+	}
+
+private:
+	///<summary>Pops free message.</summary>
+	///<remarks>Expects that interrupts are disabled.</remarks>
+	///<returns>Free message or nullptr if there are no free buffers.</returns>
+	Message* pop()
+	{
+		return static_cast<Message*>(static_cast<message*>(free_.pop_front()));
+	}
+
+private:
+	Message messages_[Count];
+	container::forward_list_tagged<message::list_element_type> free_;
+	wait_list waiters_;
+};
+
+///Mailbox, which passes ownership of messages (usually allocated from message_pool) between processes.
+///Messages are received in FIFO order.
+///<typeparam name="Message">Message type. Must be derived from message.</typeparam>
+template<typename Message>
+class mailbox : public nonmovable
+{
+public:
+	///<summary>Sends message and wakes up process waiting for message.</summary>
+	///<remarks>Has O(1) time complexity. Can be called from ISR. Message must not be accessed by sender
+	///after sending, until it is passed back to sender.</remarks>
+	///<param name="msg">Message. Can not be nullptr.</param>
+	void send(Message* msg) ATMOS_NONNULL(2)
+	{
+		atmos::kernel_lock lock;
+		message::list_element_type* elem = msg;
+		if(last_)
+		{
+			message_list::set_next(elem, message_list::next(last_));
+			message_list::set_next(last_, elem);
+		}
+		else
+		{
+			messages_.push_front(elem);
+		}
+
+		last_ = elem;
+		receivers_.notify_one();
+	}
+
+	///<summary>Receives message. Blocks current process while mailbox is empty.</summary>
+	///<returns>Received message.</returns>
+	Message* receive()
+	{
+		atmos::kernel_lock lock;
+		receivers_.wait([this] { return !messages_.empty(); });
+		return pop();
+	}
+
+	///<summary>Receives message. Blocks current process while mailbox is empty,
+	///         but not longer than timeout.</summary>
+	///<param name="ticks">Timeout in scheduler ticks.</param>
+	///<returns>Received message or nullptr if timeout expired.</returns>
+	Message* receive_for(process::tick_t ticks)
+	{
+		atmos::kernel_lock lock;
+		if(!receivers_.wait_for(ticks, [this] { return !messages_.empty(); }))
+			return nullptr;
+
+		return pop();
+	}
+
+	///<summary>Receives message, if mailbox is not empty.</summary>
+	///<remarks>Can be called from ISR.</remarks>
+	///<returns>Received message or nullptr if mailbox is empty.</returns>
+	Message* try_receive()
+	{
+		atmos::kernel_lock lock;
+		return pop();
+	}
+
+private:
+	using message_list = container::forward_list_tagged<message::list_element_type>;
+
+	///<summary>Pops first message.</summary>
+	///<remarks>Expects that interrupts are disabled.</remarks>
+	///<returns>First message or nullptr if mailbox is empty.</returns>
+	Message* pop()
+	{
+		auto* elem = messages_.pop_front();
+		if(elem == last_)
+			last_ = nullptr;
+
+		return static_cast<Message*>(static_cast<message*>(elem));
+	}
+
+private:
+	message_list messages_;
+	///Last queued message, or nullptr if mailbox is empty.
+	message::list_element_type* last_ = nullptr;
+	wait_list receivers_;
+};
+
+} //namespace atmos
+
+#endif //ATMOS_SUPPORT_SLEEP
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "config.h"
+
+#if ATMOS_SUPPORT_SLEEP
+
+#include "kernel_lock.h"
+#include "noncopyable.h"
+#include "process.h"
+#include "wait_list.h"
+
+namespace atmos
+{
+
+///Mutex (non-recursive). Blocked processes take the mutex in FIFO order.
+///unlock() passes mutex directly to the first blocked process, which is moved
+///to the list of running processes and is run next.
+///Mutex must be unlocked by the process that has locked it. Must not be used from ISR.
+class mutex : public nonmovable
+{
+public:
+	///<summary>Locks mutex. Blocks current process while mutex is locked by other process.</summary>
+	void lock()
+	{
+		atmos::kernel_lock lock;
+		if(!locked_)
+		{
+			locked_ = true;
+			return;
+		}
+
+		//Mutex is passed to this process directly by unlock().
+		waiters_.wait();
+	}
+
+	///<summary>Locks mutex. Blocks current process while mutex is locked by other process,
+	///         but not longer than timeout.</summary>
+	///<param name="ticks">Timeout in scheduler ticks. If zero, function does not block.</param>
+	///<returns>True if mutex was locked, false if timeout expired.</returns>
+	bool lock_for(process::tick_t ticks)
+	{
+		atmos::kernel_lock lock;
+		if(!locked_)
+		{
+			locked_ = true;
+			return true;
+		}
+
+		return waiters_.wait_for(ticks);
+	}
+
+	///<summary>Locks mutex, if it is not locked.</summary>
+	///<returns>True if mutex was locked.</returns>
+	bool try_lock()
+	{
+		atmos::kernel_lock lock;
+		if(locked_)
+			return false;
+
+		locked_ = true;
+		return true;
+	}
+
+	///<summary>Unlocks mutex. Mutex is passed to the first blocked process, if any.</summary>
+	///<remarks>Has O(1) time complexity, if first blocked process waits without timeout
+	///(see wait_list::wait_for) or ATMOS_DOUBLY_LINKED_PROCESS_LISTS is enabled.</remarks>
+	void unlock()
+	{
+		atmos::kernel_lock lock;
+		if(!waiters_.notify_one())
+			locked_ = false;
+	}
+
+private:
+	bool locked_ = false;
+	wait_list waiters_;
+};
+
+} //namespace atmos
+
+#endif //ATMOS_SUPPORT_SLEEP
@@ -3,9 +3,11 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "chrono.h"
 #include "config.h"
 #include "defines.h"
 #include "forward_list.h"
+#include "list.h"
 #include "static_class.h"
 
 namespace atmos
@@ -14,6 +16,8 @@ namespace atmos
 template<size_t RequiredStackSize>
 class ATMOS_PACKED process_memory_block;
 
+struct process_descriptor;
+
 ///OS process definitions and API functions.
 class process final : public static_class
 {
@@ -35,6 +39,40 @@ public:
 	using tick_t = ATMOS_TICK_COUNTER_TYPE;
 #endif //ATMOS_SUPPORT_SLEEP
 
+#if ATMOS_SUPPORT_PRIORITIES
+	///Process priority type. Greater value means higher priority.
+	using priority_type = uint8_t;
+#endif //ATMOS_SUPPORT_PRIORITIES
+
+#if ATMOS_SUPPORT_SLEEP
+	///State of process waiting in wait list with timeout.
+	enum class timed_wait_state : uint8_t
+	{
+		///Process does not wait with timeout.
+		none,
+		///Process is contained in wait list and in list of sleeping processes at the same time.
+		waiting,
+		///Timeout expired, process is contained in wait list and in list of running (or suspended) processes.
+		timed_out,
+		///Process was removed from wait list by notification.
+		notified
+	};
+	
+	///List of processes, which process is contained in (wait lists of kernel objects are not counted).
+	///Allows to move process between lists without searching them.
+	enum class process_list_type : uint8_t
+	{
+		///Process is not contained in any list of processes (it waits without timeout).
+		none,
+		///Process is contained in the list of running processes.
+		running,
+		///Process is contained in one of the lists of sleeping processes.
+		sleeping,
+		///Process is contained in the list of suspended processes.
+		suspended
+	};
+#endif //ATMOS_SUPPORT_SLEEP
+
 public:
 	///Process control block.
 	struct ATMOS_PACKED control_block
@@ -43,21 +81,77 @@ public:
 		stack_pointer_type stack_pointer = 0;
 #if ATMOS_SUPPORT_SLEEP
 		tick_t sleep_until = 0;
+		///State of wait with timeout (see wait_list::wait_for).
+		timed_wait_state timed_wait = timed_wait_state::none;
+		///List of processes, which process is contained in.
+		process_list_type list = process_list_type::none;
 #endif //ATMOS_SUPPORT_SLEEP
+#if ATMOS_SUPPORT_STATISTICS
+		///Number of times process was switched to (wraps around).
+		uint16_t run_count = 0;
+		///True if process was woken up by scheduler tick and has not run since then.
+		bool wake_up_pending = false;
+#endif //ATMOS_SUPPORT_STATISTICS
+#if ATMOS_SUPPORT_PRIORITIES
+		///Process priority (see process::set_priority).
+		priority_type priority = 0;
+#endif //ATMOS_SUPPORT_PRIORITIES
+#if ATMOS_SUPPORT_PREEMPTION_THRESHOLD
+		///Process preemption threshold (see process::set_preemption_threshold).
+		priority_type preemption_threshold = 0;
+#endif //ATMOS_SUPPORT_PREEMPTION_THRESHOLD
+#if ATMOS_SUPPORT_SUSPEND
+		///True if process is suspended. Suspended process is moved to the list of suspended processes
+		///instead of the list of running processes.
+		bool suspended = false;
+#endif //ATMOS_SUPPORT_SUSPEND
 	};
 	
 public:
 	struct process_list_tag;
 	struct process_list_element;
+#if ATMOS_DOUBLY_LINKED_PROCESS_LISTS
+	///Special tag that is used to initialize global process list.
+	using process_list_element_tagged = container::list_element_tagged<
+		process_list_tag, process_list_element>;
+	///List of processes (running, sleeping or suspended).
+	using process_list = container::list_tagged<process_list_element_tagged>;
+#else //ATMOS_DOUBLY_LINKED_PROCESS_LISTS
 	///Special tag that is used to initialize global process list.
 	using process_list_element_tagged = container::forward_list_element_tagged<
 		process_list_tag, process_list_element>;
+	///List of processes (running, sleeping or suspended).
+	using process_list = container::forward_list_tagged<process_list_element_tagged>;
+#endif //ATMOS_DOUBLY_LINKED_PROCESS_LISTS
 
+#if ATMOS_SUPPORT_SLEEP
+	struct wait_list_tag;
+#	if ATMOS_DOUBLY_LINKED_PROCESS_LISTS
+	///Link of process in wait list of kernel object (see wait_list).
+	using wait_list_element_tagged = container::list_element_tagged<
+		wait_list_tag, process_list_element>;
+	///List of processes waiting for kernel object.
+	using waiter_list = container::list_tagged<wait_list_element_tagged>;
+#	else //ATMOS_DOUBLY_LINKED_PROCESS_LISTS
+	///Link of process in wait list of kernel object (see wait_list).
+	using wait_list_element_tagged = container::forward_list_element_tagged<
+		wait_list_tag, process_list_element>;
+	///List of processes waiting for kernel object.
+	using waiter_list = container::forward_list_tagged<wait_list_element_tagged>;
+#	endif //ATMOS_DOUBLY_LINKED_PROCESS_LISTS
+
+	///Element of process list.
+	struct ATMOS_PACKED process_list_element : process_list_element_tagged, wait_list_element_tagged
+	{
+		control_block process;
+	};
+#else //ATMOS_SUPPORT_SLEEP
 	///Element of process list.
 	struct ATMOS_PACKED process_list_element : process_list_element_tagged
 	{
 		control_block process;
 	};
+#endif //ATMOS_SUPPORT_SLEEP
 
 public:
 	///Invalid process ID.
@@ -72,21 +166,51 @@ public:
 	static_assert(false, "Unknown program counter size");
 #endif //__AVR_3_BYTE_PC__
 	
+#if ATMOS_PREEMPTIVE
 	///Size of all general purpose registers in bytes.
-#if __AVR_ARCH__ == 100 //avrtiny, absent r0-r15 registers
+#	if __AVR_ARCH__ == 100 //avrtiny, absent r0-r15 registers
 	static constexpr size_t gpr_size = sizeof(uint8_t) * 16;
-#else //avrtiny
+#	else //avrtiny
 	static constexpr size_t gpr_size = sizeof(uint8_t) * 32;
-#endif //avrtiny
+#	endif //avrtiny
+#else //ATMOS_PREEMPTIVE
+	///Size of general purpose registers saved in process context in bytes. Only call-saved registers
+	///are saved in cooperative mode (r18, r19, r28, r29 for avrtiny, r2-r17, r28, r29 otherwise).
+#	if __AVR_ARCH__ == 100 //avrtiny, absent r0-r15 registers
+	static constexpr size_t gpr_size = sizeof(uint8_t) * 4;
+#	else //avrtiny
+	static constexpr size_t gpr_size = sizeof(uint8_t) * 18;
+#	endif //avrtiny
+#endif //ATMOS_PREEMPTIVE
 	
 	///Size of SREG register in bytes.
 	static constexpr size_t sreg_size = sizeof(uint8_t);
 	
+	///Size of canary word placed between process control block and process stack.
+#if ATMOS_STACK_OVERFLOW_CHECK
+	static constexpr size_t stack_canary_size = sizeof(uint16_t);
+	///Value of canary word.
+	static constexpr uint16_t stack_canary_value = 0xA55Au;
+#else //ATMOS_STACK_OVERFLOW_CHECK
+	static constexpr size_t stack_canary_size = 0;
+#endif //ATMOS_STACK_OVERFLOW_CHECK
+	
+	///Size of process stack space reserved for scheduler, which runs on the stack of process it switches from
+	///(see ATMOS_SCHEDULER_STACK_SIZE).
+#if !ATMOS_USE_INTERRUPT_STACK && (ATMOS_SUPPORT_STATISTICS || ATMOS_SUPPORT_CPU_LOAD \
+	|| ATMOS_SUPPORT_SUSPEND || ATMOS_SUPPORT_PRIORITIES || (ATMOS_SUPPORT_SLEEP && !ATMOS_PREEMPTIVE))
+	static constexpr size_t scheduler_stack_size = ATMOS_SCHEDULER_STACK_SIZE;
+#else //scheduler uses process stack
+	static constexpr size_t scheduler_stack_size = 0;
+#endif //scheduler uses process stack
+	
 	///Minimal process context size.
 	static constexpr size_t minimal_context_size = gpr_size
 		+ sreg_size
 		+ program_counter_size //return address to process
-		+ sizeof(process_list_element);
+		+ sizeof(process_list_element)
+		+ stack_canary_size
+		+ scheduler_stack_size;
 	
 public:
 	///<summary>Creates new process with specified entry point
@@ -101,35 +225,154 @@ public:
 		return create(entry_point, memory.get_memory(), RequiredStackSize + minimal_context_size);
 	}
 	
+#if ATMOS_SUPPORT_PROCESS_DESCRIPTORS
+	///<summary>Creates new process described by descriptor in program memory.</summary>
+	///<param name="descriptor">Process descriptor in program memory (see process_descriptor.h).</param>
+	///<returns>New process ID.</returns>
+	static id_type create(const process_descriptor* descriptor);
+	
+	///<summary>Creates processes described by descriptor table in program memory.
+	///         Table is remembered, so that created processes can be inspected (see get_descriptor).</summary>
+	///<remarks>Must be called once.</remarks>
+	///<param name="table">Process descriptor table in program memory.</param>
+	///<param name="count">Number of descriptors in table.</param>
+	static void create_all(const process_descriptor* table, uint8_t count);
+	
+	///<summary>Creates processes described by descriptor table in program memory (see create_all).</summary>
+	///<param name="table">Process descriptor table in program memory.</param>
+	template<uint8_t Count>
+	static void create_all(const process_descriptor (&table)[Count])
+	{
+		create_all(table, Count);
+	}
+	
+	///<summary>Returns descriptor of process created by create_all().</summary>
+	///<remarks>Has O(n) time complexity, as descriptor table is searched for process memory address.</remarks>
+	///<param name="pid">Process ID.</param>
+	///<returns>Process descriptor in program memory, or nullptr if process is not described by the table.</returns>
+	static const process_descriptor* get_descriptor(id_type pid);
+	
+	///<summary>Returns name of process created by create_all().</summary>
+	///<param name="pid">Process ID.</param>
+	///<returns>Process name in program memory, or nullptr if process has no name.</returns>
+	static const char* get_name(id_type pid);
+#endif //ATMOS_SUPPORT_PROCESS_DESCRIPTORS
+	
 #if ATMOS_SUPPORT_SLEEP || ATMOS_SUPPORT_YIELD
 	///<summary>Yields execution from current process to another.</summary>
 	static void ATMOS_NOINLINE ATMOS_NAKED yield();
 #endif //ATMOS_SUPPORT_SLEEP || ATMOS_SUPPORT_YIELD
 
 #if ATMOS_SUPPORT_SLEEP
+	///<summary>Yields execution from current process directly to another running process,
+	///         which then runs before other running processes.</summary>
+	///<remarks>If priorities are enabled (see ATMOS_SUPPORT_PRIORITIES), execution is handed off only to process
+	///with the same priority as current process, and only if no running process has higher priority.</remarks>
+	///<param name="pid">ID of process to run next.</param>
+	///<returns>True if target process was running and execution was handed off to it. False if target process
+	///         is current process, sleeps, waits, is suspended or has different priority, or if some running process
+	///         has higher priority. Current process just yields then.</returns>
+	static bool yield_to(id_type pid);
+	
 	///<summary>Suspends execution of current process
 	///         for specified amount of scheduler ticks.</summary>
 	///<param name="ticks">Number of ticks to sleep for.</param>
 	static void sleep_ticks(tick_t ticks);
 	
+	///<summary>Suspends execution of current process for specified duration.
+	///         Duration is rounded up to scheduler ticks.</summary>
+	///<remarks>Fails to compile, if duration may not fit tick counter type (see chrono::to_ticks).</remarks>
+	///<param name="duration">Duration to sleep for.</param>
+	template<typename Rep, uint32_t PeriodUs, Rep MaxCount>
+	static void sleep_for(chrono::duration<Rep, PeriodUs, MaxCount> duration)
+	{
+		sleep_ticks(chrono::to_ticks(duration));
+	}
+	
+	///<summary>Suspends execution of current process until specified time point.</summary>
+	///<remarks>Tick counter wraps around, so time point more than half of tick counter range ahead of current time
+	///is treated as already passed. Time point must therefore be less than half of the range ahead.</remarks>
+	///<param name="wake_up_time">Time point to sleep until. If it is equal to current time or has already passed,
+	///process just yields.</param>
+	static void sleep_until(chrono::time_point wake_up_time);
+	
 	///<summary>Suspends execution of current process
 	///         for specified amount of microseconds.</summary>
+	///<remarks>Duration is rounded up to scheduler ticks and limited to maximal tick counter value.</remarks>
 	///<param name="ticks">Number of microseconds to sleep for.</param>
 	template<typename T>
 	static void sleep_us(T microseconds)
 	{
-		sleep_ticks(static_cast<tick_t>(microseconds / ATMOS_TICK_PERIOD_US));
+		using rep = chrono::detail::unsigned_rep<T>;
+		sleep_ticks(chrono::to_ticks_saturated(chrono::microseconds<rep>(static_cast<rep>(microseconds))));
 	}
 	
 	///<summary>Suspends execution of current process
 	///         for specified amount of milliseconds.</summary>
+	///<remarks>Duration is rounded up to scheduler ticks and limited to maximal tick counter value.</remarks>
 	///<param name="ticks">Number of milliseconds to sleep for.</param>
 	template<typename T>
 	static void sleep_ms(T milliseconds)
 	{
-		sleep_ticks(static_cast<tick_t>(1000ul * milliseconds / ATMOS_TICK_PERIOD_US));
+		using rep = chrono::detail::unsigned_rep<T>;
+		sleep_ticks(chrono::to_ticks_saturated(chrono::milliseconds<rep>(static_cast<rep>(milliseconds))));
 	}
 #endif //ATMOS_SUPPORT_SLEEP
+
+#if ATMOS_SUPPORT_SUSPEND
+	///<summary>Suspends process. Running process is moved to the list of suspended processes. Sleeping or waiting
+	///         process keeps sleeping or waiting, and is moved to the list of suspended processes when woken up.</summary>
+	///<remarks>If current process suspends itself, it yields execution. Must not be called from interrupt handlers.
+	///You may also need to enable system process (see ATMOS_ENABLE_SYSTEM_PROCESS).
+	///Has O(1) time complexity with ATMOS_DOUBLY_LINKED_PROCESS_LISTS.</remarks>
+	///<param name="pid">Process ID.</param>
+	static void suspend(id_type pid);
+	
+	///<summary>Resumes suspended process. If process was woken up while suspended, it is moved back
+	///         to the list of running processes.</summary>
+	///<remarks>Can be called from ATMOS_ISR interrupt handlers (see interrupt.h). Like wait_list notification,
+	///context switch to resumed process is performed on the next scheduler tick or ATMOS_ISR interrupt handler exit.
+	///If priorities are enabled, process which resumes higher priority process switches to it right away
+	///(except for cooperative mode). Has O(1) time complexity with ATMOS_DOUBLY_LINKED_PROCESS_LISTS,
+	///except for insertion into the list of running processes in priority order.</remarks>
+	///<param name="pid">Process ID.</param>
+	static void resume(id_type pid);
+#endif //ATMOS_SUPPORT_SUSPEND
+
+#if ATMOS_SUPPORT_PRIORITIES
+	///<summary>Changes process priority. Running process is moved within the list of running processes.</summary>
+	///<remarks>If called from process, and some running process has priority above current process priority then,
+	///current process switches to it right away (except for cooperative mode). Otherwise new priority takes effect
+	///on the next scheduler tick or ATMOS_ISR interrupt handler exit. Running process is removed in O(1) time
+	///with ATMOS_DOUBLY_LINKED_PROCESS_LISTS, and is inserted back in priority order.</remarks>
+	///<param name="pid">Process ID.</param>
+	///<param name="priority">New process priority.</param>
+	static void set_priority(id_type pid, priority_type priority);
+	
+	///<summary>Returns process priority.</summary>
+	///<param name="pid">Process ID.</param>
+	///<returns>Process priority.</returns>
+	static priority_type get_priority(id_type pid);
+#endif //ATMOS_SUPPORT_PRIORITIES
+
+#if ATMOS_SUPPORT_PREEMPTION_THRESHOLD
+	///<summary>Changes process preemption threshold. While process runs, scheduler tick or ATMOS_ISR interrupt handler
+	///         switches to another process only if it has priority above the threshold.</summary>
+	///<remarks>Threshold which is not above process priority has no effect, which is the default.
+	///Processes with priority not above the threshold are not time-sliced with the running process either.
+	///Process still yields to other processes when it calls process::yield, sleeps or waits.
+	///If threshold of current process is lowered from process, and some running process has priority above it then,
+	///current process switches to it right away. Otherwise lowered threshold takes effect on the next scheduler tick
+	///or ATMOS_ISR interrupt handler exit.</remarks>
+	///<param name="pid">Process ID.</param>
+	///<param name="threshold">New preemption threshold.</param>
+	static void set_preemption_threshold(id_type pid, priority_type threshold);
+	
+	///<summary>Returns process preemption threshold.</summary>
+	///<param name="pid">Process ID.</param>
+	///<returns>Process preemption threshold.</returns>
+	static priority_type get_preemption_threshold(id_type pid);
+#endif //ATMOS_SUPPORT_PREEMPTION_THRESHOLD
 	
 private:
 	///<summary>Creates new process with specified entry point,
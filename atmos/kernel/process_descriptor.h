@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "config.h"
+
+#if ATMOS_SUPPORT_PROCESS_DESCRIPTORS
+
+#include <avr/pgmspace.h>
+
+#include "defines.h"
+#include "process.h"
+#include "process_memory.h"
+
+namespace atmos
+{
+
+///Constant process description, which is placed to program memory (PROGMEM) to save RAM.
+///Descriptor is read with pgm_read_* functions when process is created and inspected,
+///while process control block in RAM contains only mutable scheduler state.
+struct ATMOS_PACKED process_descriptor
+{
+	///Process entry point.
+	process::entry_point_type entry_point;
+	///Pre-allocated process memory (see process_memory_block).
+	void* memory;
+	///Size of pre-allocated process memory in bytes.
+	uint16_t memory_size;
+#if ATMOS_SUPPORT_PRIORITIES
+	///Initial process priority.
+	process::priority_type priority;
+#endif //ATMOS_SUPPORT_PRIORITIES
+	///Process name in program memory, or nullptr.
+	const char* name;
+};
+
+///<summary>Makes process descriptor. Can be used to initialize PROGMEM descriptor table.</summary>
+///<param name="entry_point">Process entry point.</param>
+///<param name="memory">Pre-allocated process memory.</param>
+///<param name="name">Process name in program memory, or nullptr.</param>
+///<param name="priority">Initial process priority.</param>
+///<returns>Process descriptor.</returns>
+#if ATMOS_SUPPORT_PRIORITIES
+template<size_t RequiredStackSize>
+constexpr process_descriptor make_process_descriptor(process::entry_point_type entry_point,
+	process_memory_block<RequiredStackSize>& memory, const char* name = nullptr, process::priority_type priority = 0)
+{
+	return { entry_point, &memory, process_memory_block<RequiredStackSize>::memory_block_size, priority, name };
+}
+#else //ATMOS_SUPPORT_PRIORITIES
+template<size_t RequiredStackSize>
+constexpr process_descriptor make_process_descriptor(process::entry_point_type entry_point,
+	process_memory_block<RequiredStackSize>& memory, const char* name = nullptr)
+{
+	return { entry_point, &memory, process_memory_block<RequiredStackSize>::memory_block_size, name };
+}
+#endif //ATMOS_SUPPORT_PRIORITIES
+
+} //namespace atmos
+
+#endif //ATMOS_SUPPORT_PROCESS_DESCRIPTORS
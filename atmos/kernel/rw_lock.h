@@ -0,0 +1,212 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "config.h"
+
+#if ATMOS_SUPPORT_SLEEP
+
+#include "kernel_lock.h"
+#include "noncopyable.h"
+#include "process.h"
+#include "wait_list.h"
+
+namespace atmos
+{
+
+///Reader/writer lock. Several processes can hold the lock for reading (shared lock) at the same time,
+///while writing (exclusive lock) is allowed to single process only. Interrupts are disabled only for
+///a short time to update lock state, and not for the whole time the lock is held.
+///Lock is writer-preferring: when some writer is blocked, new readers are blocked too, so that writers are not
+///starved by readers, and waiting writers take the lock before waiting readers.
+///Lock is passed directly to blocked processes (like semaphore does), which then run next.
+///Must not be used from ISR.
+class rw_lock : public nonmovable
+{
+public:
+	///Lock counter type.
+	using count_type = uint8_t;
+
+public:
+	///<summary>Takes shared lock. Blocks current process while lock is held by writer or some writer is blocked.</summary>
+	void lock_shared()
+	{
+		atmos::kernel_lock lock;
+		if(can_read())
+		{
+			++readers_;
+			return;
+		}
+
+		++waiting_readers_;
+		//Lock is passed to this process directly by unlock() or by writer timeout.
+		readers_waiting_.wait();
+	}
+
+	///<summary>Takes shared lock. Blocks current process while lock is held by writer or some writer is blocked,
+	///         but not longer than timeout.</summary>
+	///<param name="ticks">Timeout in scheduler ticks. If zero, function does not block.</param>
+	///<returns>True if shared lock was taken, false if timeout expired.</returns>
+	bool lock_shared_for(process::tick_t ticks)
+	{
+		atmos::kernel_lock lock;
+		if(can_read())
+		{
+			++readers_;
+			return true;
+		}
+
+		++waiting_readers_;
+		if(readers_waiting_.wait_for(ticks))
+			return true;
+
+		--waiting_readers_;
+		return false;
+	}
+
+	///<summary>Takes shared lock, if it is not held by writer and no writer is blocked.</summary>
+	///<returns>True if shared lock was taken.</returns>
+	bool try_lock_shared()
+	{
+		atmos::kernel_lock lock;
+		if(!can_read())
+			return false;
+
+		++readers_;
+		return true;
+	}
+
+	///<summary>Releases shared lock. Last reader passes the lock to the first blocked writer.</summary>
+	void unlock_shared()
+	{
+		atmos::kernel_lock lock;
+		if(!--readers_ && waiting_writers_)
+			pass_to_writer();
+	}
+
+	///<summary>Takes exclusive lock. Blocks current process while lock is held by other processes.</summary>
+	void lock()
+	{
+		atmos::kernel_lock lock;
+		if(can_write())
+		{
+			writer_ = true;
+			return;
+		}
+
+		++waiting_writers_;
+		//Lock is passed to this process directly by unlock() or unlock_shared().
+		writers_waiting_.wait();
+	}
+
+	///<summary>Takes exclusive lock. Blocks current process while lock is held by other processes,
+	///         but not longer than timeout.</summary>
+	///<param name="ticks">Timeout in scheduler ticks. If zero, function does not block.</param>
+	///<returns>True if exclusive lock was taken, false if timeout expired.</returns>
+	bool lock_for(process::tick_t ticks)
+	{
+		atmos::kernel_lock lock;
+		if(can_write())
+		{
+			writer_ = true;
+			return true;
+		}
+
+		++waiting_writers_;
+		if(writers_waiting_.wait_for(ticks))
+			return true;
+
+		//Readers, which were blocked only because of this writer, can take the lock now.
+		if(!--waiting_writers_ && !writer_)
+			pass_to_readers();
+
+		return false;
+	}
+
+	///<summary>Takes exclusive lock, if it is not held by other processes.</summary>
+	///<returns>True if exclusive lock was taken.</returns>
+	bool try_lock()
+	{
+		atmos::kernel_lock lock;
+		if(!can_write())
+			return false;
+
+		writer_ = true;
+		return true;
+	}
+
+	///<summary>Releases exclusive lock. Lock is passed to the first blocked writer,
+	///         or to all blocked readers, if there are no blocked writers.</summary>
+	void unlock()
+	{
+		atmos::kernel_lock lock;
+		if(waiting_writers_)
+		{
+			pass_to_writer();
+			return;
+		}
+
+		writer_ = false;
+		pass_to_readers();
+	}
+
+	///<summary>Returns number of processes holding shared lock.</summary>
+	///<returns>Number of readers.</returns>
+	count_type readers() const
+	{
+		atmos::kernel_lock lock;
+		return readers_;
+	}
+
+private:
+	///<summary>Returns true if shared lock can be taken without blocking.</summary>
+	///<remarks>Expects that interrupts are disabled.</remarks>
+	///<returns>True if lock is not held by writer and no writer is blocked.</returns>
+	bool can_read() const
+	{
+		return !writer_ && !waiting_writers_;
+	}
+
+	///<summary>Returns true if exclusive lock can be taken without blocking.</summary>
+	///<remarks>Expects that interrupts are disabled.</remarks>
+	///<returns>True if lock is not held.</returns>
+	bool can_write() const
+	{
+		//Writers are blocked only when lock is held, so there are no blocked writers here.
+		return !writer_ && !readers_;
+	}
+
+	///<summary>Passes exclusive lock to the first blocked writer.</summary>
+	///<remarks>Expects that interrupts are disabled and that there is blocked writer.</remarks>
+	void pass_to_writer()
+	{
+		--waiting_writers_;
+		writer_ = true;
+		writers_waiting_.notify_one();
+	}
+
+	///<summary>Passes shared lock to all blocked readers.</summary>
+	///<remarks>Expects that interrupts are disabled and that lock is not held by writer.</remarks>
+	void pass_to_readers()
+	{
+		readers_ += waiting_readers_;
+		waiting_readers_ = 0;
+		readers_waiting_.notify_all();
+	}
+
+private:
+	///Number of processes holding shared lock.
+	count_type readers_ = 0;
+	///Number of blocked readers, including ones whose timeout has expired, but which have not run yet.
+	count_type waiting_readers_ = 0;
+	///Number of blocked writers, including ones whose timeout has expired, but which have not run yet.
+	count_type waiting_writers_ = 0;
+	///True if exclusive lock is held.
+	bool writer_ = false;
+	wait_list readers_waiting_;
+	wait_list writers_waiting_;
+};
+
+} //namespace atmos
+
+#endif //ATMOS_SUPPORT_SLEEP
@@ -4,6 +4,7 @@
 
 #include <stdint.h>
 
+#include "config.h"
 #include "timer_params.h"
 
 namespace atmos
@@ -11,6 +12,13 @@ namespace atmos
 
 namespace detail
 {
+///Maximal scheduler timer counter and top value.
+#if ATMOS_TIMER_BITS == 16 || defined(ATMOS_TIMER_HAS_16BIT_MODE)
+constexpr uint16_t scheduler_timer_max_value = UINT16_MAX;
+#else //16-bit timer
+constexpr uint16_t scheduler_timer_max_value = UINT8_MAX;
+#endif //16-bit timer
+
 ///Helper class for timer setup, that is needed to save several bytes of program memory,
 ///when prescaler control register and mode control register have same addresses.
 template<uint16_t PrescalerRegister, uint16_t ModeRegister>
@@ -33,22 +41,179 @@ struct timer_setup_helper<PrescalerRegister, PrescalerRegister> final
 		ATMOS_TIMER_PRESCALER_CONTROL = ATMOS_TIMER_PRESCALER_CONTROL_VALUE | _BV(ATMOS_TIMER_CTC_MODE_BIT);
 	}
 };
+
+#if ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+///Timer prescaler value and combination of prescaler control bits to enable it.
+struct scheduler_timer_prescaler final
+{
+	uint16_t value;
+	uint8_t control_value;
+};
+
+///Prescalers supported by scheduler timer in ascending order.
+constexpr scheduler_timer_prescaler scheduler_timer_prescalers[] = {
+#	ifdef ATMOS_TIMER_PRESCALER_HAS_16384
+	{ 1, _BV(ATMOS_TIMER_PRESCALER_CS0) },
+	{ 2, _BV(ATMOS_TIMER_PRESCALER_CS1) },
+	{ 4, _BV(ATMOS_TIMER_PRESCALER_CS0) | _BV(ATMOS_TIMER_PRESCALER_CS1) },
+	{ 8, _BV(ATMOS_TIMER_PRESCALER_CS2) },
+	{ 16, _BV(ATMOS_TIMER_PRESCALER_CS2) | _BV(ATMOS_TIMER_PRESCALER_CS0) },
+	{ 32, _BV(ATMOS_TIMER_PRESCALER_CS2) | _BV(ATMOS_TIMER_PRESCALER_CS1) },
+	{ 64, _BV(ATMOS_TIMER_PRESCALER_CS2) | _BV(ATMOS_TIMER_PRESCALER_CS1) | _BV(ATMOS_TIMER_PRESCALER_CS0) },
+	{ 128, _BV(ATMOS_TIMER_PRESCALER_CS3) },
+	{ 256, _BV(ATMOS_TIMER_PRESCALER_CS3) | _BV(ATMOS_TIMER_PRESCALER_CS0) },
+	{ 512, _BV(ATMOS_TIMER_PRESCALER_CS3) | _BV(ATMOS_TIMER_PRESCALER_CS1) },
+	{ 1024, _BV(ATMOS_TIMER_PRESCALER_CS3) | _BV(ATMOS_TIMER_PRESCALER_CS0) | _BV(ATMOS_TIMER_PRESCALER_CS1) },
+	{ 2048, _BV(ATMOS_TIMER_PRESCALER_CS3) | _BV(ATMOS_TIMER_PRESCALER_CS2) },
+	{ 4096, _BV(ATMOS_TIMER_PRESCALER_CS3) | _BV(ATMOS_TIMER_PRESCALER_CS2) | _BV(ATMOS_TIMER_PRESCALER_CS0) },
+	{ 8192, _BV(ATMOS_TIMER_PRESCALER_CS3) | _BV(ATMOS_TIMER_PRESCALER_CS2) | _BV(ATMOS_TIMER_PRESCALER_CS1) },
+	{ 16384, _BV(ATMOS_TIMER_PRESCALER_CS3) | _BV(ATMOS_TIMER_PRESCALER_CS2) | _BV(ATMOS_TIMER_PRESCALER_CS1) | _BV(ATMOS_TIMER_PRESCALER_CS0) }
+#	elif defined(ATMOS_TIMER_PRESCALER_HAS_32_128)
+	{ 1, _BV(ATMOS_TIMER_PRESCALER_CS0) },
+	{ 8, _BV(ATMOS_TIMER_PRESCALER_CS1) },
+	{ 32, _BV(ATMOS_TIMER_PRESCALER_CS0) | _BV(ATMOS_TIMER_PRESCALER_CS1) },
+	{ 64, _BV(ATMOS_TIMER_PRESCALER_CS2) },
+	{ 128, _BV(ATMOS_TIMER_PRESCALER_CS2) | _BV(ATMOS_TIMER_PRESCALER_CS0) },
+	{ 256, _BV(ATMOS_TIMER_PRESCALER_CS2) | _BV(ATMOS_TIMER_PRESCALER_CS1) },
+	{ 1024, _BV(ATMOS_TIMER_PRESCALER_CS2) | _BV(ATMOS_TIMER_PRESCALER_CS1) | _BV(ATMOS_TIMER_PRESCALER_CS0) }
+#	else //ATMOS_TIMER_PRESCALER_HAS_32_128
+	{ 1, _BV(ATMOS_TIMER_PRESCALER_CS0) },
+	{ 8, _BV(ATMOS_TIMER_PRESCALER_CS1) },
+	{ 64, _BV(ATMOS_TIMER_PRESCALER_CS0) | _BV(ATMOS_TIMER_PRESCALER_CS1) },
+	{ 256, _BV(ATMOS_TIMER_PRESCALER_CS2) },
+	{ 1024, _BV(ATMOS_TIMER_PRESCALER_CS2) | _BV(ATMOS_TIMER_PRESCALER_CS0) }
+#	endif //ATMOS_TIMER_PRESCALER_HAS_32_128
+};
+
+///Mask of all scheduler timer prescaler control bits.
+#	ifdef ATMOS_TIMER_PRESCALER_HAS_16384
+constexpr uint8_t scheduler_timer_prescaler_mask = _BV(ATMOS_TIMER_PRESCALER_CS0) | _BV(ATMOS_TIMER_PRESCALER_CS1)
+	| _BV(ATMOS_TIMER_PRESCALER_CS2) | _BV(ATMOS_TIMER_PRESCALER_CS3);
+#	else //ATMOS_TIMER_PRESCALER_HAS_16384
+constexpr uint8_t scheduler_timer_prescaler_mask = _BV(ATMOS_TIMER_PRESCALER_CS0) | _BV(ATMOS_TIMER_PRESCALER_CS1)
+	| _BV(ATMOS_TIMER_PRESCALER_CS2);
+#	endif //ATMOS_TIMER_PRESCALER_HAS_16384
+
+///Scheduler timer configuration for some tick period.
+struct scheduler_timer_params final
+{
+	///Combination of prescaler control bits.
+	uint8_t prescaler_control_value;
+	///Value that should be written to timer CTC compare register. Zero if configuration is invalid.
+	uint16_t top_value;
+};
+
+///<summary>Calculates scheduler timer configuration for specified tick period at compile time.
+///         Selects the smallest prescaler which provides required tick period, like timer_params.h does.</summary>
+///<param name="tick_period_us">Tick period in microseconds.</param>
+///<returns>Timer configuration. Top value is zero if scheduler timer can not provide required tick period.</returns>
+constexpr scheduler_timer_params calculate_scheduler_timer_params(uint32_t tick_period_us)
+{
+	for(const auto& prescaler : scheduler_timer_prescalers)
+	{
+		auto top_value = (1ull * tick_period_us * F_CPU) / (1ull * prescaler.value * 1000000);
+		if(top_value > 0 && top_value <= scheduler_timer_max_value)
+			return { prescaler.control_value, static_cast<uint16_t>(top_value) };
+	}
+	
+	return { 0, 0 };
+}
+#endif //ATMOS_SUPPORT_TICK_PERIOD_CHANGE
 } //namespace detail
 
+#if ATMOS_PREEMPTIVE
 ///Initializes scheduler timer according to ATMOS_TIMER_INDEX and ATMOS_TICK_PERIOD_US macro values.
 ///These parameters are set in config.h.
+///If timer is 8-bit, but supports 16-bit mode, this mode is enabled to get longer and more accurate ticks.
 inline void initialize_scheduler_timer()
 {
+#	ifdef ATMOS_TIMER_HAS_16BIT_MODE
+	//High byte of compare value must be written first.
+	ATMOS_TIMER_16BIT_MODE_HIGH_BYTE_COMPARE_REGISTER = static_cast<uint8_t>(ATMOS_TIMER_TOP_VALUE >> 8);
+	ATMOS_TIMER_COMPARE_REGISTER = static_cast<uint8_t>(ATMOS_TIMER_TOP_VALUE);
+#	else //ATMOS_TIMER_HAS_16BIT_MODE
 	ATMOS_TIMER_COMPARE_REGISTER = ATMOS_TIMER_TOP_VALUE;
+#	endif //ATMOS_TIMER_HAS_16BIT_MODE
 	
-#ifdef ATMOS_TIMER_MODE_CONTROL
+#	ifdef ATMOS_TIMER_MODE_CONTROL
 	detail::timer_setup_helper<(reinterpret_cast<uint16_t>(&ATMOS_TIMER_PRESCALER_CONTROL)),
 		(reinterpret_cast<uint16_t>(&ATMOS_TIMER_MODE_CONTROL))>::setup();
-#else //ATMOS_TIMER_MODE_CONTROL
+#	else //ATMOS_TIMER_MODE_CONTROL
 	ATMOS_TIMER_PRESCALER_CONTROL = ATMOS_TIMER_PRESCALER_CONTROL_VALUE;
-#endif //ATMOS_TIMER_MODE_CONTROL
+#	endif //ATMOS_TIMER_MODE_CONTROL
+	
+#	ifdef ATMOS_TIMER_HAS_16BIT_MODE
+	//Mode control register may be the same as 16-bit mode control register, so this is done after mode setup.
+	ATMOS_TIMER_16BIT_MODE_CONTROL |= _BV(ATMOS_TIMER_16BIT_MODE_BIT);
+#	endif //ATMOS_TIMER_HAS_16BIT_MODE
 	
 	ATMOS_TIMER_INTERRUPT_CONTROL = _BV(ATMOS_TIMER_COMPARE_INTERRUPT_BIT);
 }
+#else //ATMOS_PREEMPTIVE
+///Initializes scheduler timer for cooperative mode. Timer runs freely in normal mode with the same prescaler
+///as in preemptive mode, so that ATMOS_TIMER_TOP_VALUE timer counts make a tick. Timer interrupt is not enabled.
+///If timer is 8-bit, but supports 16-bit mode, this mode is enabled to get longer overflow period.
+inline void initialize_scheduler_timer()
+{
+	//Mode control bits are cleared (or left cleared), which selects normal mode.
+	ATMOS_TIMER_PRESCALER_CONTROL = ATMOS_TIMER_PRESCALER_CONTROL_VALUE;
+#	ifdef ATMOS_TIMER_HAS_16BIT_MODE
+	ATMOS_TIMER_16BIT_MODE_CONTROL |= _BV(ATMOS_TIMER_16BIT_MODE_BIT);
+#	endif //ATMOS_TIMER_HAS_16BIT_MODE
+}
+#endif //ATMOS_PREEMPTIVE
+
+#if ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+///<summary>Changes configuration of running scheduler timer. Timer counter is reset,
+///         so current tick is restarted and timer never runs past the new top value.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+///<param name="prescaler_control_value">Combination of prescaler control bits.</param>
+///<param name="top_value">Value to write to timer CTC compare register.</param>
+inline void reconfigure_scheduler_timer(uint8_t prescaler_control_value, uint16_t top_value)
+{
+#	ifdef ATMOS_TIMER_HAS_16BIT_MODE
+	//High bytes must be written first.
+	ATMOS_TIMER_16BIT_MODE_HIGH_BYTE_COMPARE_REGISTER = static_cast<uint8_t>(top_value >> 8);
+	ATMOS_TIMER_COMPARE_REGISTER = static_cast<uint8_t>(top_value);
+	ATMOS_TIMER_16BIT_MODE_HIGH_BYTE_COUNTER_REGISTER = 0;
+	ATMOS_TIMER_COUNTER = 0;
+#	else //ATMOS_TIMER_HAS_16BIT_MODE
+	ATMOS_TIMER_COMPARE_REGISTER = top_value;
+	ATMOS_TIMER_COUNTER = 0;
+#	endif //ATMOS_TIMER_HAS_16BIT_MODE
+	
+	//Prescaler control register may also contain mode control bits, which must be preserved.
+	ATMOS_TIMER_PRESCALER_CONTROL = (ATMOS_TIMER_PRESCALER_CONTROL & ~detail::scheduler_timer_prescaler_mask)
+		| prescaler_control_value;
+}
+#endif //ATMOS_SUPPORT_TICK_PERIOD_CHANGE
+
+///<summary>Reads scheduler timer counter, which is reset on each scheduler tick.</summary>
+///<remarks>Expects that interrupts are disabled. Counter is not reset in cooperative mode (see ATMOS_PREEMPTIVE),
+///as timer runs freely and wraps around at its maximal value (see detail::scheduler_timer_max_value).</remarks>
+///<returns>Number of timer counts passed since the beginning of current tick.</returns>
+inline uint16_t get_scheduler_timer_counter()
+{
+#ifdef ATMOS_TIMER_HAS_16BIT_MODE
+	//Low byte must be read first, high byte is latched on low byte read.
+	uint8_t low = ATMOS_TIMER_COUNTER;
+	return static_cast<uint16_t>(ATMOS_TIMER_16BIT_MODE_HIGH_BYTE_COUNTER_REGISTER << 8) | low;
+#else //ATMOS_TIMER_HAS_16BIT_MODE
+	return ATMOS_TIMER_COUNTER;
+#endif //ATMOS_TIMER_HAS_16BIT_MODE
+}
+
+///<summary>Reads scheduler timer CTC compare register.</summary>
+///<remarks>Expects that interrupts are disabled.</remarks>
+///<returns>Scheduler timer top value (tick length in timer counts minus one).</returns>
+inline uint16_t get_scheduler_timer_top()
+{
+#ifdef ATMOS_TIMER_HAS_16BIT_MODE
+	uint8_t low = ATMOS_TIMER_COMPARE_REGISTER;
+	return static_cast<uint16_t>(ATMOS_TIMER_16BIT_MODE_HIGH_BYTE_COMPARE_REGISTER << 8) | low;
+#else //ATMOS_TIMER_HAS_16BIT_MODE
+	return ATMOS_TIMER_COMPARE_REGISTER;
+#endif //ATMOS_TIMER_HAS_16BIT_MODE
+}
 
 } //namespace atmos
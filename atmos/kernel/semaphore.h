@@ -0,0 +1,104 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "config.h"
+
+#if ATMOS_SUPPORT_SLEEP
+
+#include "kernel_lock.h"
+#include "noncopyable.h"
+#include "process.h"
+#include "wait_list.h"
+
+namespace atmos
+{
+
+///Counting semaphore. Blocked processes take the semaphore in FIFO order.
+///give() passes semaphore unit directly to the first blocked process, which is moved
+///to the list of running processes and is run next. If give() is called from ATMOS_ISR
+///interrupt handler, the process is run right on handler exit (see interrupt.h).
+class semaphore : public nonmovable
+{
+public:
+	///Semaphore counter type.
+	using count_type = uint16_t;
+
+public:
+	///<summary>Creates semaphore.</summary>
+	///<param name="initial_count">Initial semaphore count.</param>
+	constexpr explicit semaphore(count_type initial_count = 0)
+		: count_(initial_count)
+	{
+	}
+
+	///<summary>Takes semaphore unit. Blocks current process while semaphore count is zero.</summary>
+	void take()
+	{
+		atmos::kernel_lock lock;
+		if(count_)
+		{
+			--count_;
+			return;
+		}
+
+		//Unit is passed to this process directly by give().
+		waiters_.wait();
+	}
+
+	///<summary>Takes semaphore unit. Blocks current process while semaphore count is zero,
+	///         but not longer than timeout.</summary>
+	///<param name="ticks">Timeout in scheduler ticks. If zero, function does not block.</param>
+	///<returns>True if semaphore unit was taken, false if timeout expired.</returns>
+	bool take_for(process::tick_t ticks)
+	{
+		atmos::kernel_lock lock;
+		if(count_)
+		{
+			--count_;
+			return true;
+		}
+
+		return waiters_.wait_for(ticks);
+	}
+
+	///<summary>Takes semaphore unit, if semaphore count is not zero.</summary>
+	///<remarks>Can be called from ISR.</remarks>
+	///<returns>True if semaphore unit was taken.</returns>
+	bool try_take()
+	{
+		atmos::kernel_lock lock;
+		if(!count_)
+			return false;
+
+		--count_;
+		return true;
+	}
+
+	///<summary>Gives semaphore unit to the first blocked process, or increments semaphore count,
+	///         if there are no blocked processes.</summary>
+	///<remarks>Can be called from ISR. Has O(1) time complexity, if first blocked process
+	///waits without timeout (see wait_list::wait_for) or ATMOS_DOUBLY_LINKED_PROCESS_LISTS is enabled.</remarks>
+	void give()
+	{
+		atmos::kernel_lock lock;
+		if(!waiters_.notify_one())
+			++count_;
+	}
+
+	///<summary>Returns semaphore count.</summary>
+	///<returns>Number of units available.</returns>
+	count_type count() const
+	{
+		atmos::kernel_lock lock;
+		return count_;
+	}
+
+private:
+	count_type count_;
+	wait_list waiters_;
+};
+
+} //namespace atmos
+
+#endif //ATMOS_SUPPORT_SLEEP
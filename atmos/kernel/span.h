@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stddef.h>
+
+namespace atmos
+{
+
+///Non-owning view of contiguous sequence of elements.
+///<typeparam name="T">Element type. Can be const-qualified.</typeparam>
+template<typename T>
+class span final
+{
+public:
+	using element_type = T;
+	using size_type = size_t;
+	using iterator = T*;
+
+public:
+	///Creates empty span.
+	constexpr span()
+		: data_(nullptr)
+		, size_(0)
+	{
+	}
+
+	///<summary>Creates span.</summary>
+	///<param name="data">Pointer to the first element. Can be nullptr, if size is zero.</param>
+	///<param name="size">Number of elements.</param>
+	constexpr span(T* data, size_type size)
+		: data_(data)
+		, size_(size)
+	{
+	}
+
+	///<summary>Creates span, which refers to all elements of array.</summary>
+	template<size_type Size>
+	constexpr span(T (&data)[Size])
+		: data_(data)
+		, size_(Size)
+	{
+	}
+
+	///<summary>Creates span of const elements from span of mutable elements.</summary>
+	template<typename U>
+	constexpr span(span<U> other)
+		: data_(other.data())
+		, size_(other.size())
+	{
+	}
+
+	constexpr T* data() const
+	{
+		return data_;
+	}
+
+	constexpr size_type size() const
+	{
+		return size_;
+	}
+
+	constexpr bool empty() const
+	{
+		return !size_;
+	}
+
+	constexpr T& operator[](size_type index) const
+	{
+		return data_[index];
+	}
+
+	constexpr iterator begin() const
+	{
+		return data_;
+	}
+
+	constexpr iterator end() const
+	{
+		return data_ + size_;
+	}
+
+	///<summary>Returns span of count elements starting from offset.</summary>
+	constexpr span subspan(size_type offset, size_type count) const
+	{
+		return span(data_ + offset, count);
+	}
+
+	///<summary>Returns span of elements starting from offset.</summary>
+	constexpr span subspan(size_type offset) const
+	{
+		return span(data_ + offset, size_ - offset);
+	}
+
+private:
+	T* data_;
+	size_type size_;
+};
+
+} //namespace atmos
@@ -0,0 +1,188 @@
+#include "config.h"
+
+#if ATMOS_SINGLE_STACK_MODE
+
+#include "task.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wframe-larger-than="
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+
+#include "context_switch.h"
+#include "defines.h"
+#include "forward_list.h"
+#include "kernel.h"
+#include "kernel_lock.h"
+#include "scheduler_timer_setup.h"
+
+#pragma GCC diagnostic pop
+
+namespace atmos
+{
+namespace detail
+{
+
+///Single-stack kernel scheduler state.
+struct task_scheduler final
+{
+	using task_list = container::forward_list_tagged<task::list_element_type>;
+
+	///Activated tasks sorted by priority (highest first).
+	static task_list pending_tasks;
+
+	///Priority of currently running task (zero when idle loop is running).
+	static task::priority_type current_priority;
+
+#if ATMOS_SUPPORT_SLEEP
+	///Tasks waiting for activation. Each task delay is relative to previous task delay.
+	static task_list delayed_tasks;
+
+	///Scheduler tick counter.
+	static task::tick_t tick_counter;
+#endif //ATMOS_SUPPORT_SLEEP
+
+	///<summary>Adds task to pending task list.</summary>
+	///<remarks>Expects that interrupts are disabled.</remarks>
+	static void make_pending(task::list_element_type* target) ATMOS_NONNULL(1)
+	{
+		auto priority = (*target)->priority_;
+		pending_tasks.insert_before(target, [priority](const task* before)
+		{
+			return before->priority_ < priority;
+		});
+	}
+
+#if ATMOS_SUPPORT_SLEEP
+	///<summary>Increments tick count and activates tasks which delays are over.</summary>
+	///<remarks>Expects that interrupts are disabled.</remarks>
+	static void ATMOS_ALWAYS_INLINE tick_and_activate_tasks()
+	{
+		++tick_counter;
+
+		auto* first = delayed_tasks.first();
+		if(!first)
+			return;
+
+		--(*first)->delay_;
+		while(first && !(*first)->delay_)
+		{
+			delayed_tasks.pop_front();
+			make_pending(first);
+			first = delayed_tasks.first();
+		}
+	}
+#endif //ATMOS_SUPPORT_SLEEP
+};
+
+task_scheduler::task_list task_scheduler::pending_tasks{};
+task::priority_type task_scheduler::current_priority = 0;
+#if ATMOS_SUPPORT_SLEEP
+task_scheduler::task_list task_scheduler::delayed_tasks{};
+task::tick_t task_scheduler::tick_counter = 0;
+#endif //ATMOS_SUPPORT_SLEEP
+
+} //namespace detail
+
+void task::activate()
+{
+	bool interrupts_enabled = SREG & _BV(ATMOS_AVR_INTERRUPT_BIT);
+
+	{
+		atmos::kernel_lock lock;
+		if(queued_)
+			return;
+
+		queued_ = true;
+		detail::task_scheduler::make_pending(this);
+	}
+
+	if(interrupts_enabled)
+		dispatch();
+}
+
+#if ATMOS_SUPPORT_SLEEP
+void task::activate_after(tick_t ticks)
+{
+	if(!ticks)
+	{
+		activate();
+		return;
+	}
+
+	atmos::kernel_lock lock;
+	if(queued_)
+		return;
+
+	queued_ = true;
+	detail::task_scheduler::delayed_tasks.insert_before(this, [&ticks](task* before)
+	{
+		if(ticks < before->delay_)
+		{
+			//Task is inserted before "before" task, so "before" task delay becomes relative to it.
+			before->delay_ -= ticks;
+			return true;
+		}
+
+		ticks -= before->delay_;
+		return false;
+	});
+	delay_ = ticks;
+}
+#endif //ATMOS_SUPPORT_SLEEP
+
+void task::dispatch()
+{
+	using detail::task_scheduler;
+
+	atmos::kernel_lock lock;
+	while(true)
+	{
+		auto* next = task_scheduler::pending_tasks.first();
+		if(!next || (*next)->priority_ <= task_scheduler::current_priority)
+			break;
+
+		task_scheduler::pending_tasks.pop_front();
+		(*next)->queued_ = false;
+
+		//Run preempting task with interrupts enabled on top of the current stack.
+		auto preempted_priority = task_scheduler::current_priority;
+		task_scheduler::current_priority = (*next)->priority_;
+		sei();
+		(*next)->entry_point_();
+		cli();
+		task_scheduler::current_priority = preempted_priority;
+	}
+}
+
+void kernel::run()
+{
+	initialize_scheduler_timer();
+	sei();
+
+	//Idle loop. Runs tasks activated with interrupts disabled.
+	while(true)
+		task::dispatch();
+}
+
+#if ATMOS_SUPPORT_SLEEP
+task::tick_t kernel::get_tick_count()
+{
+	atmos::kernel_lock lock;
+	return detail::task_scheduler::tick_counter;
+}
+#endif //ATMOS_SUPPORT_SLEEP
+
+} //namespace atmos
+
+//Scheduler interrupt. Counts ticks and runs activated tasks.
+ISR(ATMOS_TIMER_INTERRUPT_NAME, ATMOS_HOT)
+{
+#if ATMOS_SUPPORT_SLEEP
+	atmos::detail::task_scheduler::tick_and_activate_tasks();
+#endif //ATMOS_SUPPORT_SLEEP
+	atmos::task::dispatch();
+}
+
+#endif //ATMOS_SINGLE_STACK_MODE
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "config.h"
+
+#if ATMOS_SINGLE_STACK_MODE
+
+#include "defines.h"
+#include "forward_list.h"
+#include "noncopyable.h"
+
+namespace atmos
+{
+
+namespace detail
+{
+struct task_scheduler;
+} //namespace detail
+
+struct task_list_tag;
+
+///Run-to-completion task for single-stack kernel mode (see ATMOS_SINGLE_STACK_MODE).
+///Task is a function that is called each time the task is activated. All tasks share the
+///hardware stack: activated task with higher priority than currently running one is called
+///immediately, nesting on the stack of the task (or interrupt) it preempts.
+///Resources shared between tasks and interrupts are protected by kernel_lock.
+class task final : public container::forward_list_element_tagged<task_list_tag, task>, public nonmovable
+{
+public:
+	///Task entry point type.
+	using entry_point_type = void(*)();
+
+	///Task priority type. Larger value means higher priority. Zero priority is reserved for idle loop.
+	using priority_type = uint8_t;
+
+#if ATMOS_SUPPORT_SLEEP
+	using tick_t = ATMOS_TICK_COUNTER_TYPE;
+#endif //ATMOS_SUPPORT_SLEEP
+
+public:
+	///<summary>Creates task with specified entry point and priority.</summary>
+	///<param name="entry_point">Task function. Must return when task work is done.</param>
+	///<param name="priority">Task priority. Must be greater than zero.</param>
+	constexpr task(entry_point_type entry_point, priority_type priority)
+		: entry_point_(entry_point)
+		, priority_(priority)
+	{
+	}
+
+	///<summary>Activates task. Task will be run as soon as no task with same or higher
+	///         priority is running. Does nothing if task is already activated.</summary>
+	///<remarks>Can be called from ISR. ISRs which activate tasks should call dispatch() before return.
+	///If called with interrupts enabled, higher priority task is run immediately.</remarks>
+	void activate();
+
+#if ATMOS_SUPPORT_SLEEP
+	///<summary>Activates task after specified amount of scheduler ticks.</summary>
+	///<remarks>Can be called from ISR. Does nothing if task is already activated.</remarks>
+	///<param name="ticks">Number of ticks to wait before activation. Zero activates the task immediately.</param>
+	void activate_after(tick_t ticks);
+#endif //ATMOS_SUPPORT_SLEEP
+
+	///<summary>Returns task priority.</summary>
+	///<returns>Task priority.</returns>
+	priority_type get_priority() const
+	{
+		return priority_;
+	}
+
+	///<summary>Runs all activated tasks with priority higher than priority of current task.</summary>
+	///<remarks>Can be called from ISR (interrupts are enabled while tasks run, ISR returns when
+	///all preempting tasks are completed) and after kernel_lock release.</remarks>
+	static void dispatch();
+
+private:
+	///Task function.
+	entry_point_type entry_point_;
+	///Task priority.
+	priority_type priority_;
+	///True if task is in either pending or delayed task list.
+	bool queued_ = false;
+#if ATMOS_SUPPORT_SLEEP
+	///Number of ticks to wait after previous task in delayed task list.
+	tick_t delay_ = 0;
+#endif //ATMOS_SUPPORT_SLEEP
+
+	friend struct detail::task_scheduler;
+};
+
+} //namespace atmos
+
+#endif //ATMOS_SINGLE_STACK_MODE
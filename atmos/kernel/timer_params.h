@@ -13,7 +13,10 @@
  *  ATMOS_TIMER_PRESCALER_CONTROL_VALUE - bit mask that should be used to configure timer prescaler;
  *  ATMOS_TIMER_TOP_VALUE - value that should be written to timer CTC compare register. */
 
-#if ATMOS_TIMER_BITS == 8
+#ifdef ATMOS_TIMER_HAS_16BIT_MODE
+	//8-bit timer is switched to 16-bit mode by initialize_scheduler_timer().
+#	define ATMOS_MAX_TIMER_VALUE UINT16_MAX
+#elif ATMOS_TIMER_BITS == 8
 #	define ATMOS_MAX_TIMER_VALUE UINT8_MAX
 #elif ATMOS_TIMER_BITS == 16
 #	define ATMOS_MAX_TIMER_VALUE UINT16_MAX
@@ -21,7 +24,11 @@
 static_cast("Unsupported ATMOS_TIMER_BITS value");
 #endif //ATMOS_TIMER_BITS
 
-#pragma message ("Selected timer #" STRINGIFY(ATMOS_TIMER_INDEX) " (" STRINGIFY(ATMOS_TIMER_BITS) "-bit)")
+#ifdef ATMOS_TIMER_HAS_16BIT_MODE
+#	pragma message ("Selected timer #" STRINGIFY(ATMOS_TIMER_INDEX) " (" STRINGIFY(ATMOS_TIMER_BITS) "-bit, 16-bit mode)")
+#else //ATMOS_TIMER_HAS_16BIT_MODE
+#	pragma message ("Selected timer #" STRINGIFY(ATMOS_TIMER_INDEX) " (" STRINGIFY(ATMOS_TIMER_BITS) "-bit)")
+#endif //ATMOS_TIMER_HAS_16BIT_MODE
 #pragma message ("Selected timer tick period " STRINGIFY(ATMOS_TICK_PERIOD_US) " us")
 
 //Try to get required timer parameters for all possible timer prescaler values.
@@ -72,7 +79,7 @@ static_cast("Unsupported ATMOS_TIMER_BITS value");
 #	include "timer_params_calc.h"
 #endif //ATMOS_TIMER_PRESCALER_CONTROL_VALUE
 #ifndef ATMOS_TIMER_PRESCALER_CONTROL_VALUE
-#	define ATMOS_TIMER_PRESCALER_VALUE 4196
+#	define ATMOS_TIMER_PRESCALER_VALUE 4096
 #	include "timer_params_calc.h"
 #endif //ATMOS_TIMER_PRESCALER_CONTROL_VALUE
 #ifndef ATMOS_TIMER_PRESCALER_CONTROL_VALUE
@@ -24,13 +24,10 @@
 #	define ATMOS_TIMER_INTERRUPT_NAME ATMOS_TIMER0_INTERRUPT_NAME
 #	define ATMOS_TIMER_COUNTER ATMOS_TIMER0_COUNTER
 #	ifdef ATMOS_TIMER0_PRESCALER_HAS_32_128
-#		#define ATMOS_TIMER_PRESCALER_HAS_32_128
-#	endif //ATMOS_TIMER0_PRESCALER_HAS_32_128
-#	ifdef ATMOS_TIMER0_PRESCALER_HAS_32_128
-#		#define ATMOS_TIMER_PRESCALER_HAS_32_128
+#		define ATMOS_TIMER_PRESCALER_HAS_32_128
 #	endif //ATMOS_TIMER0_PRESCALER_HAS_32_128
 #	ifdef ATMOS_TIMER0_PRESCALER_HAS_16384
-#		define ATMOS_TIMER0_PRESCALER_HAS_16384
+#		define ATMOS_TIMER_PRESCALER_HAS_16384
 #	endif //ATMOS_TIMER0_PRESCALER_HAS_16384
 #	ifdef ATMOS_TIMER0_HAS_16BIT_MODE
 #		define ATMOS_TIMER_HAS_16BIT_MODE
@@ -56,13 +53,10 @@
 #	define ATMOS_TIMER_INTERRUPT_NAME ATMOS_TIMER1_INTERRUPT_NAME
 #	define ATMOS_TIMER_COUNTER ATMOS_TIMER1_COUNTER
 #	ifdef ATMOS_TIMER1_PRESCALER_HAS_32_128
-#		#define ATMOS_TIMER_PRESCALER_HAS_32_128
-#	endif //ATMOS_TIMER1_PRESCALER_HAS_32_128
-#	ifdef ATMOS_TIMER1_PRESCALER_HAS_32_128
-#		#define ATMOS_TIMER_PRESCALER_HAS_32_128
+#		define ATMOS_TIMER_PRESCALER_HAS_32_128
 #	endif //ATMOS_TIMER1_PRESCALER_HAS_32_128
 #	ifdef ATMOS_TIMER1_PRESCALER_HAS_16384
-#		define ATMOS_TIMER1_PRESCALER_HAS_16384
+#		define ATMOS_TIMER_PRESCALER_HAS_16384
 #	endif //ATMOS_TIMER1_PRESCALER_HAS_16384
 #	ifdef ATMOS_TIMER1_HAS_16BIT_MODE
 #		define ATMOS_TIMER_HAS_16BIT_MODE
@@ -88,13 +82,10 @@
 #	define ATMOS_TIMER_INTERRUPT_NAME ATMOS_TIMER2_INTERRUPT_NAME
 #	define ATMOS_TIMER_COUNTER ATMOS_TIMER2_COUNTER
 #	ifdef ATMOS_TIMER2_PRESCALER_HAS_32_128
-#		#define ATMOS_TIMER_PRESCALER_HAS_32_128
-#	endif //ATMOS_TIMER2_PRESCALER_HAS_32_128
-#	ifdef ATMOS_TIMER2_PRESCALER_HAS_32_128
-#		#define ATMOS_TIMER_PRESCALER_HAS_32_128
+#		define ATMOS_TIMER_PRESCALER_HAS_32_128
 #	endif //ATMOS_TIMER2_PRESCALER_HAS_32_128
 #	ifdef ATMOS_TIMER2_PRESCALER_HAS_16384
-#		define ATMOS_TIMER2_PRESCALER_HAS_16384
+#		define ATMOS_TIMER_PRESCALER_HAS_16384
 #	endif //ATMOS_TIMER2_PRESCALER_HAS_16384
 #	ifdef ATMOS_TIMER2_HAS_16BIT_MODE
 #		define ATMOS_TIMER_HAS_16BIT_MODE
@@ -120,13 +111,10 @@
 #	define ATMOS_TIMER_INTERRUPT_NAME ATMOS_TIMER3_INTERRUPT_NAME
 #	define ATMOS_TIMER_COUNTER ATMOS_TIMER3_COUNTER
 #	ifdef ATMOS_TIMER3_PRESCALER_HAS_32_128
-#		#define ATMOS_TIMER_PRESCALER_HAS_32_128
-#	endif //ATMOS_TIMER3_PRESCALER_HAS_32_128
-#	ifdef ATMOS_TIMER3_PRESCALER_HAS_32_128
-#		#define ATMOS_TIMER_PRESCALER_HAS_32_128
+#		define ATMOS_TIMER_PRESCALER_HAS_32_128
 #	endif //ATMOS_TIMER3_PRESCALER_HAS_32_128
 #	ifdef ATMOS_TIMER3_PRESCALER_HAS_16384
-#		define ATMOS_TIMER3_PRESCALER_HAS_16384
+#		define ATMOS_TIMER_PRESCALER_HAS_16384
 #	endif //ATMOS_TIMER3_PRESCALER_HAS_16384
 #	ifdef ATMOS_TIMER3_HAS_16BIT_MODE
 #		define ATMOS_TIMER_HAS_16BIT_MODE
@@ -152,13 +140,10 @@
 #	define ATMOS_TIMER_INTERRUPT_NAME ATMOS_TIMER4_INTERRUPT_NAME
 #	define ATMOS_TIMER_COUNTER ATMOS_TIMER4_COUNTER
 #	ifdef ATMOS_TIMER4_PRESCALER_HAS_32_128
-#		#define ATMOS_TIMER_PRESCALER_HAS_32_128
-#	endif //ATMOS_TIMER4_PRESCALER_HAS_32_128
-#	ifdef ATMOS_TIMER4_PRESCALER_HAS_32_128
-#		#define ATMOS_TIMER_PRESCALER_HAS_32_128
+#		define ATMOS_TIMER_PRESCALER_HAS_32_128
 #	endif //ATMOS_TIMER4_PRESCALER_HAS_32_128
 #	ifdef ATMOS_TIMER4_PRESCALER_HAS_16384
-#		define ATMOS_TIMER4_PRESCALER_HAS_16384
+#		define ATMOS_TIMER_PRESCALER_HAS_16384
 #	endif //ATMOS_TIMER4_PRESCALER_HAS_16384
 #	ifdef ATMOS_TIMER4_HAS_16BIT_MODE
 #		define ATMOS_TIMER_HAS_16BIT_MODE
@@ -184,13 +169,10 @@
 #	define ATMOS_TIMER_INTERRUPT_NAME ATMOS_TIMER5_INTERRUPT_NAME
 #	define ATMOS_TIMER_COUNTER ATMOS_TIMER5_COUNTER
 #	ifdef ATMOS_TIMER5_PRESCALER_HAS_32_128
-#		#define ATMOS_TIMER_PRESCALER_HAS_32_128
-#	endif //ATMOS_TIMER5_PRESCALER_HAS_32_128
-#	ifdef ATMOS_TIMER5_PRESCALER_HAS_32_128
-#		#define ATMOS_TIMER_PRESCALER_HAS_32_128
+#		define ATMOS_TIMER_PRESCALER_HAS_32_128
 #	endif //ATMOS_TIMER5_PRESCALER_HAS_32_128
 #	ifdef ATMOS_TIMER5_PRESCALER_HAS_16384
-#		define ATMOS_TIMER5_PRESCALER_HAS_16384
+#		define ATMOS_TIMER_PRESCALER_HAS_16384
 #	endif //ATMOS_TIMER5_PRESCALER_HAS_16384
 #	ifdef ATMOS_TIMER5_HAS_16BIT_MODE
 #		define ATMOS_TIMER_HAS_16BIT_MODE
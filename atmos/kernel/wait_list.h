@@ -0,0 +1,102 @@
+#pragma once
+
+#include "config.h"
+
+#if ATMOS_SUPPORT_SLEEP
+
+#include "deadline.h"
+#include "defines.h"
+#include "kernel.h"
+#include "noncopyable.h"
+#include "process.h"
+
+namespace atmos
+{
+
+///List of processes blocked until some event happens. Base building block
+///for kernel objects that block processes (queues, semaphores, etc.).
+///Processes are woken up in FIFO order.
+class wait_list : public nonmovable
+{
+public:
+	///<summary>Blocks current process until it is woken up by notify_one() or notify_all().</summary>
+	///<remarks>Must be called from process with interrupts disabled (under kernel_lock),
+	///so that condition check and blocking are atomic. Interrupts are disabled on return.
+	///You may also need to enable system process (see ATMOS_ENABLE_SYSTEM_PROCESS).</remarks>
+	void wait();
+
+	///<summary>Blocks current process until it is woken up by notify_one() or notify_all(),
+	///         or until timeout expires.</summary>
+	///<remarks>Must be called from process with interrupts disabled (under kernel_lock),
+	///so that condition check and blocking are atomic. Interrupts are disabled on return.
+	///While waiting, process is contained both in the wait list and in the list of sleeping processes,
+	///so notify_one() and notify_all() also remove the process from the list of sleeping processes
+	///(O(1) with ATMOS_DOUBLY_LINKED_PROCESS_LISTS, O(n) otherwise).</remarks>
+	///<param name="ticks">Timeout in scheduler ticks. If zero, function returns false immediately.</param>
+	///<returns>True if process was woken up by notification, false if timeout expired.</returns>
+	bool wait_for(process::tick_t ticks);
+
+	///<summary>Blocks current process until predicate returns true.</summary>
+	///<remarks>Same requirements as for wait() apply. Predicate is called with interrupts disabled.</remarks>
+	///<param name="ready">Predicate to check condition which process waits for.</param>
+	template<typename Predicate>
+	void wait(Predicate&& ready)
+	{
+		while(!ready())
+			wait();
+	}
+
+	///<summary>Blocks current process until predicate returns true or timeout expires.</summary>
+	///<remarks>Same requirements as for wait_for() apply. Predicate is called with interrupts disabled.
+	///Process may be woken up several times before condition is met, timeout is counted from the first call.</remarks>
+	///<param name="ticks">Timeout in scheduler ticks.</param>
+	///<param name="ready">Predicate to check condition which process waits for.</param>
+	///<returns>True if predicate returned true, false if timeout expired.</returns>
+	template<typename Predicate>
+	bool wait_for(process::tick_t ticks, Predicate&& ready)
+	{
+		return wait_for(deadline(ticks), ready);
+	}
+
+	///<summary>Blocks current process until predicate returns true or deadline passes.</summary>
+	///<remarks>Same requirements as for wait_for() apply. Predicate is called with interrupts disabled.
+	///The same deadline can be passed to several waits to limit total time of blocking operation.</remarks>
+	///<param name="time_limit">Deadline.</param>
+	///<param name="ready">Predicate to check condition which process waits for.</param>
+	///<returns>True if predicate returned true, false if deadline has passed.</returns>
+	template<typename Predicate>
+	bool wait_for(const deadline& time_limit, Predicate&& ready)
+	{
+		while(!ready())
+		{
+			if(!wait_for(time_limit.remaining()))
+				return false;
+		}
+
+		return true;
+	}
+
+	///<summary>Wakes up first waiting process. Woken up process is run next
+	///         to the currently running process.</summary>
+	///<remarks>Can be called from ISR.</remarks>
+	///<returns>True if some process was woken up, false if wait list is empty.</returns>
+	bool notify_one();
+
+	///<summary>Wakes up all waiting processes.</summary>
+	///<remarks>Can be called from ISR.</remarks>
+	void notify_all();
+
+	///<summary>Returns true if there are no waiting processes.</summary>
+	///<returns>True if there are no waiting processes.</returns>
+	bool empty() const
+	{
+		return waiters_.empty();
+	}
+
+private:
+	process::waiter_list waiters_;
+};
+
+} //namespace atmos
+
+#endif //ATMOS_SUPPORT_SLEEP